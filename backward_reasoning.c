@@ -0,0 +1,173 @@
+// Backward reasoning decider.
+//
+// Starts from every halting transition and walks the machine backwards, keeping track of the cells that each
+// predecessor configuration must contain. If every branch runs into a contradiction (a predecessor would have
+// written a symbol that disagrees with what the tape is known to hold) before the search runs out of depth,
+// no configuration can lead to a halt and the machine runs forever.
+//
+// A branch that reaches a configuration consistent with the blank starting tape can't be refuted, so the
+// machine is left undecided.
+
+#ifndef BACKWARD_REASONING_MAX_DEPTH
+    #define BACKWARD_REASONING_MAX_DEPTH 32
+#endif
+#ifndef BACKWARD_REASONING_MAX_NODES
+    #define BACKWARD_REASONING_MAX_NODES 100000
+#endif
+#define BACKWARD_REASONING_WINDOW (2 * BACKWARD_REASONING_MAX_DEPTH + 1)
+#define BACKWARD_REASONING_MEMO_SIZE 4096 // Must be a power of 2
+#define UNKNOWN_SYMBOL (char)-1
+
+_Static_assert(BACKWARD_REASONING_WINDOW < 256, "Head positions are stored in a u8.");
+_Static_assert((BACKWARD_REASONING_MEMO_SIZE & (BACKWARD_REASONING_MEMO_SIZE - 1)) == 0, "Memo size must be a power of 2.");
+
+typedef struct PredecessorTransition {
+    u8 from_state;
+    u8 from_symbol;
+    Direction dir;
+} PredecessorTransition;
+
+/// Maps (state, symbol) to every transition that enters that state after writing that symbol.
+/// The entries for key k live in transitions[offsets[k]] up to transitions[offsets[k + 1]].
+typedef struct PredecessorIndex {
+    PredecessorTransition transitions[STATES * SYMBOLS];
+    u16 offsets[STATES * SYMBOLS + 1];
+} PredecessorIndex;
+
+#define PREDECESSOR_KEY(state, symbol) ((usize)(state) * SYMBOLS + (usize)(symbol))
+
+PredecessorIndex predecessor_index_init(const Machine input_machine) {
+    PredecessorIndex index = {0};
+    u16 counts[STATES * SYMBOLS] = {0};
+    for (usize state = 0; state < STATES; state++) {
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            Instruction instruction = input_machine[state][symbol];
+            if ((u8)instruction.next_state >= STATES) continue;
+            counts[PREDECESSOR_KEY(instruction.next_state, instruction.write)]++;
+        }
+    }
+    for (usize key = 0; key < STATES * SYMBOLS; key++) {
+        index.offsets[key + 1] = index.offsets[key] + counts[key];
+    }
+    u16 fill[STATES * SYMBOLS];
+    memcpy(fill, index.offsets, sizeof(fill));
+    for (usize state = 0; state < STATES; state++) {
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            Instruction instruction = input_machine[state][symbol];
+            if ((u8)instruction.next_state >= STATES) continue;
+            PredecessorTransition transition = {state, symbol, instruction.dir};
+            index.transitions[fill[PREDECESSOR_KEY(instruction.next_state, instruction.write)]++] = transition;
+        }
+    }
+    return index;
+}
+
+typedef struct BackwardNode {
+    char tape[BACKWARD_REASONING_WINDOW]; // UNKNOWN_SYMBOL for cells with no constraint
+    u8 head;
+    u8 state;
+} BackwardNode;
+
+typedef struct BackwardMemoEntry {
+    BackwardNode node;
+    u32 depth_remaining; // The node was refuted with this much depth left. 0 marks an empty slot.
+} BackwardMemoEntry;
+
+typedef struct BackwardReasoningContext {
+    PredecessorIndex index;
+    usize visited_nodes;
+    u32 max_depth;
+    u32 deepest; // Longest backward path taken so far
+    BackwardMemoEntry* memo; // Refuted nodes. Anything refuted with less depth is also refuted with more.
+} BackwardReasoningContext;
+
+u64 backward_node_hash(const BackwardNode* node) {
+    u64 hash = 14695981039346656037ULL; // FNV-1a
+    const u8* bytes = (const u8*)node;
+    for (usize i = 0; i < sizeof(*node); i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool backward_node_matches_start(const BackwardNode* node) {
+    if (node->state != 0) return false;
+    for (usize i = 0; i < BACKWARD_REASONING_WINDOW; i++) {
+        if (node->tape[i] != UNKNOWN_SYMBOL && node->tape[i] != 0) return false;
+    }
+    return true;
+}
+
+/// Returns true if no configuration matching the node can be reached from the blank tape.
+bool backward_refute(BackwardReasoningContext* context, const BackwardNode* node, u32 depth_remaining) {
+    if (backward_node_matches_start(node)) return false;
+    if (depth_remaining == 0) return false;
+    if (++context->visited_nodes > BACKWARD_REASONING_MAX_NODES) return false;
+    if (context->max_depth - depth_remaining > context->deepest) {
+        context->deepest = context->max_depth - depth_remaining;
+    }
+
+    usize slot = backward_node_hash(node) & (BACKWARD_REASONING_MEMO_SIZE - 1);
+    BackwardMemoEntry* entry = &context->memo[slot];
+    if (entry->depth_remaining && entry->depth_remaining <= depth_remaining && !memcmp(&entry->node, node, sizeof(*node))) {
+        return true;
+    }
+
+    usize key = PREDECESSOR_KEY(node->state, 0);
+    for (usize written = 0; written < SYMBOLS; written++, key++) {
+        for (usize i = context->index.offsets[key]; i < context->index.offsets[key + 1]; i++) {
+            PredecessorTransition transition = context->index.transitions[i];
+            BackwardNode predecessor = *node;
+            predecessor.head -= transition.dir;
+            char* cell = &predecessor.tape[predecessor.head];
+            // The predecessor wrote `written` onto this cell, so anything else there is a contradiction.
+            if (*cell != UNKNOWN_SYMBOL && *cell != (char)written) continue;
+            *cell = transition.from_symbol;
+            predecessor.state = transition.from_state;
+            if (!backward_refute(context, &predecessor, depth_remaining - 1)) return false;
+        }
+    }
+
+    // Always overwrite the slot. Recently refuted nodes are the most likely to be seen again.
+    entry->node = *node;
+    entry->depth_remaining = depth_remaining;
+    return true;
+}
+
+/// Returns true if every halting transition is refuted within max_depth backward steps.
+/// OUT_depth_used (if it isn't NULL) receives the smallest max_depth that refutes the machine the same way,
+/// which makes checking the result again cheaper.
+bool backward_reasoning_refutes(const Machine input_machine, u32 max_depth, u32* OUT_depth_used) {
+    assert("Backward reasoning depth is larger than the tape window", max_depth <= BACKWARD_REASONING_MAX_DEPTH);
+    BackwardReasoningContext context = {.index = predecessor_index_init(input_machine), .max_depth = max_depth};
+    Arena memo_arena = arena_init(sizeof(BackwardMemoEntry) * (BACKWARD_REASONING_MEMO_SIZE + 1));
+    context.memo = aalloc_zero(&memo_arena, sizeof(BackwardMemoEntry) * BACKWARD_REASONING_MEMO_SIZE);
+
+    bool refuted = true;
+    for (usize state = 0; state < STATES && refuted; state++) {
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            if (input_machine[state][symbol].next_state != HALT_STATE) continue;
+            BackwardNode halting_node;
+            memset(halting_node.tape, UNKNOWN_SYMBOL, sizeof(halting_node.tape));
+            halting_node.head = BACKWARD_REASONING_MAX_DEPTH;
+            halting_node.state = state;
+            halting_node.tape[halting_node.head] = symbol;
+            if (!backward_refute(&context, &halting_node, max_depth)) {
+                refuted = false;
+                break;
+            }
+        }
+    }
+    afree(&memo_arena);
+    if (OUT_depth_used) {
+        *OUT_depth_used = context.deepest + 1;
+    }
+    return refuted;
+}
+
+/// Cheap early decider. Proves a machine runs forever when none of its halting transitions can be reached
+/// by walking backwards at most BACKWARD_REASONING_MAX_DEPTH steps.
+/// OUT_depth (if it isn't NULL) receives the depth that is enough to check the result again.
+DecisionStatus decide_backward_reasoning(const Machine input_machine, u32* OUT_depth) {
+    return backward_reasoning_refutes(input_machine, BACKWARD_REASONING_MAX_DEPTH, OUT_depth) ? INFINITE : UNDECIDED;
+}
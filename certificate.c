@@ -0,0 +1,180 @@
+// Decision certificates.
+//
+// Every decided machine gets a certificate next to its verdict, so results can be checked in bulk without
+// repeating the search that found them. The text form is one token list per machine:
+//
+//     HALT <steps>               The machine halts on step <steps>, counting the halting transition.
+//     BACKWARD <depth>           Backward reasoning from every halting transition dies out within <depth> steps.
+//     CTL <left DFA> <right DFA> A closed tape language that excludes halting.
+//     BOUNCER <first> <second>   The configurations after <first> and <second> steps start a provable bouncer.
+//     -                          No certificate (undecided machines).
+//
+// A DFA is written row by row, one digit per symbol and an '_' between states. "01_11" is 0 -0-> 0, 0 -1-> 1,
+// 1 -0-> 1 and 1 -1-> 1.
+
+typedef enum CertificateKind {
+    CERTIFICATE_NONE,
+    CERTIFICATE_HALT,
+    CERTIFICATE_BACKWARD_REASONING,
+    CERTIFICATE_CLOSED_TAPE_LANGUAGE,
+    CERTIFICATE_SYMBOLIC_BOUNCER,
+} CertificateKind;
+
+typedef struct DecisionCertificate {
+    CertificateKind kind;
+    union {
+        usize halting_steps;
+        u32 backward_reasoning_depth;
+        ClosedTapeLanguageCertificate closed_tape_language;
+        usize bouncer_steps[2];
+    };
+} DecisionCertificate;
+
+#ifndef CERTIFICATE_MAX_HALTING_STEPS
+    #define CERTIFICATE_MAX_HALTING_STEPS 1000000000 // Checking a halting certificate allocates 2 bytes per step
+#endif
+
+_Static_assert(CTL_MAX_DFA_STATES <= 10, "DFA states are written as single digits.");
+
+void write_dfa(const DFA* dfa, FILE* out) {
+    for (usize state = 0; state < dfa->state_count; state++) {
+        if (state) fputc('_', out);
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            fputc(INT_TO_NUMERIC(dfa->transitions[state][symbol]), out);
+        }
+    }
+}
+
+void write_certificate(const DecisionCertificate* certificate, FILE* out) {
+    switch (certificate->kind) {
+        case CERTIFICATE_NONE: fprintf(out, "-"); break;
+        case CERTIFICATE_HALT: fprintf(out, "HALT %llu", (u64)certificate->halting_steps); break;
+        case CERTIFICATE_BACKWARD_REASONING: fprintf(out, "BACKWARD %u", certificate->backward_reasoning_depth); break;
+        case CERTIFICATE_CLOSED_TAPE_LANGUAGE: {
+            fprintf(out, "CTL ");
+            write_dfa(&certificate->closed_tape_language.left, out);
+            fputc(' ', out);
+            write_dfa(&certificate->closed_tape_language.right, out);
+        } break;
+        case CERTIFICATE_SYMBOLIC_BOUNCER:
+            fprintf(out, "BOUNCER %llu %llu", (u64)certificate->bouncer_steps[0], (u64)certificate->bouncer_steps[1]);
+            break;
+        default: assert("Unreachable", false);
+    }
+}
+
+/// For internal usage only. Consumes the next space separated token of the input.
+String _next_token(String* input) {
+    while (input->length && IS_WHITESPACE(input->str[0])) {
+        input->str++;
+        input->length--;
+    }
+    String token = {input->str, 0};
+    while (token.length < input->length && !IS_WHITESPACE(token.str[token.length])) {
+        token.length++;
+    }
+    input->str += token.length;
+    input->length -= token.length;
+    return token;
+}
+
+bool _token_equals(String token, const char* text) {
+    return token.length == strlen(text) && !memcmp(token.str, text, token.length);
+}
+
+bool _parse_unsigned(String token, u64* OUT_value) {
+    if (!token.length || token.length > 19) return false;
+    u64 value = 0;
+    for (usize i = 0; i < token.length; i++) {
+        if (!IS_NUMERIC(token.str[i])) return false;
+        value = value * 10 + NUMERIC_TO_INT(token.str[i]);
+    }
+    *OUT_value = value;
+    return true;
+}
+
+/// Parses a DFA and checks it is one the closed tape language decider could have used.
+bool _parse_dfa(String token, DFA* OUT_dfa) {
+    if ((token.length + 1) % (SYMBOLS + 1)) return false;
+    usize state_count = (token.length + 1) / (SYMBOLS + 1);
+    if (!state_count || state_count > CTL_MAX_DFA_STATES) return false;
+    OUT_dfa->state_count = state_count;
+    for (usize state = 0; state < state_count; state++) {
+        const char* row = &token.str[state * (SYMBOLS + 1)];
+        if (state && row[-1] != '_') return false;
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            if (!IS_NUMERIC(row[symbol]) || (usize)NUMERIC_TO_INT(row[symbol]) >= state_count) return false;
+            OUT_dfa->transitions[state][symbol] = NUMERIC_TO_INT(row[symbol]);
+        }
+    }
+    // The blank parts of the tape have to leave the DFA in its start state.
+    if (OUT_dfa->transitions[0][0] != 0) return false;
+    dfa_compute_preimages(OUT_dfa);
+    return true;
+}
+
+/// Parses the text form of a certificate. Returns false if it is malformed.
+bool parse_certificate(String input, DecisionCertificate* OUT_certificate) {
+    DecisionCertificate certificate = {0};
+    String kind = _next_token(&input);
+    if (_token_equals(kind, "-")) {
+        certificate.kind = CERTIFICATE_NONE;
+    } else if (_token_equals(kind, "HALT")) {
+        u64 steps;
+        if (!_parse_unsigned(_next_token(&input), &steps)) return false;
+        certificate.kind = CERTIFICATE_HALT;
+        certificate.halting_steps = steps;
+    } else if (_token_equals(kind, "BACKWARD")) {
+        u64 depth;
+        if (!_parse_unsigned(_next_token(&input), &depth) || depth > BACKWARD_REASONING_MAX_DEPTH) return false;
+        certificate.kind = CERTIFICATE_BACKWARD_REASONING;
+        certificate.backward_reasoning_depth = depth;
+    } else if (_token_equals(kind, "CTL")) {
+        certificate.kind = CERTIFICATE_CLOSED_TAPE_LANGUAGE;
+        if (!_parse_dfa(_next_token(&input), &certificate.closed_tape_language.left)) return false;
+        if (!_parse_dfa(_next_token(&input), &certificate.closed_tape_language.right)) return false;
+    } else if (_token_equals(kind, "BOUNCER")) {
+        u64 first_step, second_step;
+        if (!_parse_unsigned(_next_token(&input), &first_step)) return false;
+        if (!_parse_unsigned(_next_token(&input), &second_step)) return false;
+        certificate.kind = CERTIFICATE_SYMBOLIC_BOUNCER;
+        certificate.bouncer_steps[0] = first_step;
+        certificate.bouncer_steps[1] = second_step;
+    } else {
+        return false;
+    }
+    if (_next_token(&input).length) return false;
+    *OUT_certificate = certificate;
+    return true;
+}
+
+/// Checks that the certificate proves the verdict for the machine. This never repeats a search:
+/// a closed tape language is checked with one closure computation, and backward reasoning only goes
+/// as deep as the certificate says it has to.
+bool verify_certificate(const Machine input_machine, DecisionStatus status, const DecisionCertificate* certificate) {
+    switch (certificate->kind) {
+        case CERTIFICATE_HALT: {
+            if (status != HALTS || !certificate->halting_steps) return false;
+            // A corrupted step count must fail the line instead of the whole verifier run.
+            if (certificate->halting_steps > CERTIFICATE_MAX_HALTING_STEPS) return false;
+            // Steps + 1 cells on both sides is enough to never run out of tape.
+            TapeState tape_state = tape_state_init(2 * certificate->halting_steps + 3);
+            if (!tape_state.tape) return false;
+            bool halts = simulate_unaccelerated(input_machine, &tape_state, certificate->halting_steps - 1) == SIMULATION_MAX_STEPS &&
+                simulate_unaccelerated(input_machine, &tape_state, 1) == SIMULATION_HALTED;
+            free(tape_state.tape);
+            return halts;
+        }
+        case CERTIFICATE_BACKWARD_REASONING:
+            return status == INFINITE && backward_reasoning_refutes(input_machine, certificate->backward_reasoning_depth, NULL);
+        case CERTIFICATE_CLOSED_TAPE_LANGUAGE:
+            return status == INFINITE && ctl_check_closure(input_machine,
+                &certificate->closed_tape_language.left, &certificate->closed_tape_language.right);
+        case CERTIFICATE_SYMBOLIC_BOUNCER:
+            return status == INFINITE &&
+                symbolic_bouncer_verify(input_machine, certificate->bouncer_steps[0], certificate->bouncer_steps[1]);
+        case CERTIFICATE_NONE:
+            return status == UNDECIDED;
+        default: return false;
+    }
+}
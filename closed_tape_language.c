@@ -0,0 +1,169 @@
+// Closed tape language (CTL) decider.
+//
+// A configuration is abstracted to (L(left tape), state, head symbol, R(right tape)), where L is a DFA reading the
+// left half of the tape towards the head and R is a DFA reading the right half of the tape towards the head.
+// Both DFAs start in state 0 and loop on 0 in state 0, so the infinite blank parts of the tape don't matter.
+// The set of abstract configurations reachable from the blank tape is a regular language closed under the
+// transitions of the machine. If it never contains a halting (state, symbol) pair, the machine can't halt.
+//
+// Pushing a symbol onto either half of the tape is a DFA transition. Popping a symbol is done through the
+// preimage of the current DFA state, which over-approximates the possible tapes. That keeps the check sound.
+
+#ifndef CTL_MAX_DFA_STATES
+    #define CTL_MAX_DFA_STATES 3
+#endif
+
+_Static_assert(CTL_MAX_DFA_STATES <= 64, "DFA states are stored in u64 bitmasks.");
+
+typedef struct DFA {
+    u8 state_count;
+    u8 transitions[CTL_MAX_DFA_STATES][SYMBOLS];
+    u64 preimages[SYMBOLS][CTL_MAX_DFA_STATES]; // Bitmask of every state p where transitions[p][symbol] == state
+} DFA;
+
+typedef struct ClosedTapeLanguageCertificate {
+    DFA left;
+    DFA right;
+} ClosedTapeLanguageCertificate;
+
+// The DFAs don't depend on the machine being decided, so they are enumerated once and shared between machines.
+Arena ctl_dfa_arena;
+DFA* ctl_dfa_table;
+usize ctl_dfa_offsets[CTL_MAX_DFA_STATES + 2]; // DFAs with n states live in [ctl_dfa_offsets[n], ctl_dfa_offsets[n + 1])
+
+void dfa_compute_preimages(DFA* dfa) {
+    memset(dfa->preimages, 0, sizeof(dfa->preimages));
+    for (usize state = 0; state < dfa->state_count; state++) {
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            dfa->preimages[symbol][dfa->transitions[state][symbol]] |= (u64)1 << state;
+        }
+    }
+}
+
+/// Returns true if the transition table is the canonical representative of its isomorphism class.
+/// States have to be first referenced in increasing order when walking the table row by row,
+/// which also guarantees every state is reachable from state 0.
+bool dfa_is_canonical(const DFA* dfa) {
+    usize next_new_state = 1;
+    for (usize state = 0; state < dfa->state_count; state++) {
+        if (state >= next_new_state) return false;
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            usize target = dfa->transitions[state][symbol];
+            if (target > next_new_state) return false;
+            if (target == next_new_state) next_new_state++;
+        }
+    }
+    return next_new_state == dfa->state_count;
+}
+
+/// Enumerates every canonical DFA with up to CTL_MAX_DFA_STATES states where state 0 loops on symbol 0.
+/// Only does work on the first call.
+void ctl_dfa_table_init() {
+    if (ctl_dfa_table) return;
+    ctl_dfa_arena = arena_init(sizeof(DFA) * 1024);
+    ctl_dfa_table = (DFA*)ctl_dfa_arena.bytes;
+    usize dfa_count = 0;
+
+    for (usize state_count = 1; state_count <= CTL_MAX_DFA_STATES; state_count++) {
+        ctl_dfa_offsets[state_count] = dfa_count;
+        DFA candidate = {.state_count = state_count};
+        while (true) {
+            if (dfa_is_canonical(&candidate)) {
+                dfa_compute_preimages(&candidate);
+                *(DFA*)aalloc(&ctl_dfa_arena, sizeof(DFA)) = candidate;
+                dfa_count++;
+            }
+            // Odometer over every transition except 0 -0-> 0, which is fixed.
+            usize digit = 1;
+            for (; digit < state_count * SYMBOLS; digit++) {
+                u8* transition = &candidate.transitions[digit / SYMBOLS][digit % SYMBOLS];
+                if (++(*transition) < state_count) break;
+                *transition = 0;
+            }
+            if (digit == state_count * SYMBOLS) break;
+        }
+    }
+    ctl_dfa_offsets[CTL_MAX_DFA_STATES + 1] = dfa_count;
+    // The arena may have been moved by a reallocation while it was filled up.
+    ctl_dfa_table = (DFA*)ctl_dfa_arena.bytes;
+}
+
+/// Computes the abstract reachable set for one pair of DFAs. Returns true if it is closed and contains no halting
+/// transition, which proves the machine runs forever.
+///
+/// The set is stored bit-parallel: reachable[l][state][symbol] is the mask of right DFA states seen together with
+/// left DFA state l, so one instruction is applied to every right DFA state at once.
+bool ctl_check_closure(const Machine input_machine, const DFA* left, const DFA* right) {
+    u64 reachable[CTL_MAX_DFA_STATES][STATES][SYMBOLS] = {0};
+    reachable[0][0][0] = 1;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (usize l = 0; l < left->state_count; l++) {
+            for (usize state = 0; state < STATES; state++) {
+                for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+                    u64 right_mask = reachable[l][state][symbol];
+                    if (!right_mask) continue;
+
+                    Instruction instruction = input_machine[state][symbol];
+                    if (instruction.next_state == HALT_STATE) return false;
+
+                    if (instruction.dir == RIGHT) {
+                        usize next_l = left->transitions[l][(usize)instruction.write];
+                        for (usize popped = 0; popped < SYMBOLS; popped++) {
+                            u64 next_right_mask = 0;
+                            for (u64 bits = right_mask; bits; bits &= bits - 1) {
+                                next_right_mask |= right->preimages[popped][__builtin_ctzll(bits)];
+                            }
+                            u64* destination = &reachable[next_l][(usize)instruction.next_state][popped];
+                            if ((*destination | next_right_mask) != *destination) {
+                                *destination |= next_right_mask;
+                                changed = true;
+                            }
+                        }
+                    } else {
+                        u64 next_right_mask = 0;
+                        for (u64 bits = right_mask; bits; bits &= bits - 1) {
+                            next_right_mask |= (u64)1 << right->transitions[__builtin_ctzll(bits)][(usize)instruction.write];
+                        }
+                        for (usize popped = 0; popped < SYMBOLS; popped++) {
+                            for (u64 bits = left->preimages[popped][l]; bits; bits &= bits - 1) {
+                                u64* destination = &reachable[__builtin_ctzll(bits)][(usize)instruction.next_state][popped];
+                                if ((*destination | next_right_mask) != *destination) {
+                                    *destination |= next_right_mask;
+                                    changed = true;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// Exhaustively searches pairs of DFAs, smallest first, for a closed tape language that excludes halting.
+/// On success the DFAs are written into OUT_certificate (if it isn't NULL).
+DecisionStatus decide_closed_tape_language(const Machine input_machine, ClosedTapeLanguageCertificate* OUT_certificate) {
+    ctl_dfa_table_init();
+    for (usize total_states = 2; total_states <= 2 * CTL_MAX_DFA_STATES; total_states++) {
+        for (usize left_states = 1; left_states < total_states; left_states++) {
+            usize right_states = total_states - left_states;
+            if (left_states > CTL_MAX_DFA_STATES || right_states > CTL_MAX_DFA_STATES) continue;
+
+            for (usize l = ctl_dfa_offsets[left_states]; l < ctl_dfa_offsets[left_states + 1]; l++) {
+                for (usize r = ctl_dfa_offsets[right_states]; r < ctl_dfa_offsets[right_states + 1]; r++) {
+                    if (!ctl_check_closure(input_machine, &ctl_dfa_table[l], &ctl_dfa_table[r])) continue;
+                    if (OUT_certificate) {
+                        OUT_certificate->left = ctl_dfa_table[l];
+                        OUT_certificate->right = ctl_dfa_table[r];
+                    }
+                    return INFINITE;
+                }
+            }
+        }
+    }
+    return UNDECIDED;
+}
@@ -1,5 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
+#ifdef __AVX2__
+    #include <immintrin.h>
+#endif
 
 #ifndef PARAMS
     #define STATES 7
@@ -101,8 +104,81 @@ TMSimulationResult simulate_unaccelerated(const Machine input_machine, TapeState
     #undef CURRENT_CELL
 }
 
-void pipeline(const Machine input_machine) {
+typedef enum DecisionStatus {
+    HALTS,      // The machine was proven to halt
+    INFINITE,   // The machine was proven to run forever
+    UNDECIDED,  // The machine could not be decided.
+} DecisionStatus;
+
+const char* decision_status_name(DecisionStatus status) {
+    switch (status) {
+        case HALTS:     return "HALTS";
+        case INFINITE:  return "INFINITE";
+        case UNDECIDED: return "UNDECIDED";
+        default: assert("Unreachable", false); return NULL;
+    }
+}
+
+#include "backward_reasoning.c"
+#include "closed_tape_language.c"
+#include "symbolic_bouncer.c"
+#include "certificate.c"
+#include "progress.c"
+
+#ifndef HALTING_SIMULATION_STEPS
+    #define HALTING_SIMULATION_STEPS 4096
+#endif
+
+/// Runs the machine for up to max_steps steps. OUT_steps receives the number of steps simulated. If the machine
+/// halts that is the number of steps it took, counting the halting transition like the usual busy beaver step counts do.
+DecisionStatus decide_halting_by_simulation(const Machine input_machine, usize max_steps, usize* OUT_steps) {
+    TapeState tape_state = tape_state_init(2 * max_steps + 3);
+    DecisionStatus status = UNDECIDED;
+    *OUT_steps = max_steps;
+    for (usize step = 0; step < max_steps; step++) {
+        if (simulate_unaccelerated(input_machine, &tape_state, 1) == SIMULATION_HALTED) {
+            *OUT_steps = step + 1;
+            status = HALTS;
+            break;
+        }
+    }
+    free(tape_state.tape);
+    return status;
+}
+
+/// Runs every decider in order of cost until one of them decides the machine.
+/// The certificate for the verdict is written into OUT_certificate.
+/// If counters isn't NULL, the verdict and the number of simulated steps are added to them.
+DecisionStatus pipeline(const Machine input_machine, DecisionCertificate* OUT_certificate, ProgressCounters* counters) {
     subroutine_decompose(input_machine, 1);
+    DecisionCertificate certificate = {0};
+    DecisionStatus status = UNDECIDED;
+    usize simulated_steps = 0;
+    if (decide_backward_reasoning(input_machine, &certificate.backward_reasoning_depth) == INFINITE) {
+        certificate.kind = CERTIFICATE_BACKWARD_REASONING;
+        status = INFINITE;
+    } else if (decide_halting_by_simulation(input_machine, HALTING_SIMULATION_STEPS, &simulated_steps) == HALTS) {
+        certificate.kind = CERTIFICATE_HALT;
+        certificate.halting_steps = simulated_steps;
+        status = HALTS;
+    } else if (decide_closed_tape_language(input_machine, &certificate.closed_tape_language) == INFINITE) {
+        certificate.kind = CERTIFICATE_CLOSED_TAPE_LANGUAGE;
+        status = INFINITE;
+    } else {
+        usize bouncer_steps = 0;
+        if (decide_symbolic_bouncer(input_machine, SYMBOLIC_BOUNCER_STEPS, certificate.bouncer_steps, &bouncer_steps) == INFINITE) {
+            certificate.kind = CERTIFICATE_SYMBOLIC_BOUNCER;
+            status = INFINITE;
+        }
+        simulated_steps += bouncer_steps;
+    }
+    *OUT_certificate = certificate;
+    if (counters) {
+        progress_add(&counters->machines, 1);
+        progress_add(&counters->verdicts[status], 1);
+        progress_add(&counters->steps, simulated_steps);
+    }
+    return status;
 }
 
 typedef enum _TMCodeParseError {
@@ -160,7 +236,7 @@ _TMCodeParseError parse_machine(Machine OUT_machine, const String input_string)
             } break;
             case NEXT_STATE: {
                 // Invalid next states are interpreted as "HALT". This means you could denote it with 'H', '-', or 'Z'
-                if (IS_CAPITAL_ASCII_CHAR(char_to_process) && (char_to_process) <= ('A' + STATES) && (char_to_process) >= 'A') {
+                if (IS_CAPITAL_ASCII_CHAR(char_to_process) && (char_to_process) < ('A' + STATES) && (char_to_process) >= 'A') {
                     OUT_machine[current_state][current_symbol].next_state = (char_to_process) - 'A';
                 } else {
                     OUT_machine[current_state][current_symbol].next_state = (char)255;
@@ -193,36 +269,191 @@ _TMCodeParseError parse_machine(Machine OUT_machine, const String input_string)
     }
 }
 
-void process_parsing_error(_TMCodeParseError error) {
-    assert("Parsing of TM code failed", error == SUCCESS);
-    // TODO: Handle other cases with better error messages
+const char* parse_error_name(_TMCodeParseError error) {
+    switch (error) {
+        case SUCCESS:               return "SUCCESS";
+        case TOO_LONG:              return "TOO_LONG";
+        case TOO_SHORT:             return "TOO_SHORT";
+        case TOO_MANY_SYMBOLS:      return "TOO_MANY_SYMBOLS";
+        case TOO_FEW_SYMBOLS:       return "TOO_FEW_SYMBOLS";
+        case ILLEGAL_CHARS:         return "ILLEGAL_CHARS";
+        case INVALID_FORMAT_WRITE:  return "INVALID_FORMAT_WRITE";
+        case INVALID_FORMAT_DIR:    return "INVALID_FORMAT_DIR";
+        case BROKEN_FORMAT_GENERIC: return "BROKEN_FORMAT_GENERIC";
+        default: assert("Unreachable", false); return NULL;
+    }
+}
+
+// 3 chars per instruction + 1 underscore separator per state.
+#define TM_CODE_LENGTH (3 * (STATES * SYMBOLS) + (STATES - 1))
+#define TM_DECODE_INVALID (u8)254
+
+/// Lookup tables for decoding one instruction of a fixed width TM code. Every entry that can't appear in
+/// that position of an instruction is TM_DECODE_INVALID.
+typedef struct TMDecodeTables {
+    bool initialized;
+    u8 write[256];
+    u8 dir[256];        // Stores the direction + 1, so LEFT and RIGHT fit in a u8
+    u8 next_state[256];
+} TMDecodeTables;
+
+TMDecodeTables tm_decode_tables;
+
+void tm_decode_tables_init() {
+    if (tm_decode_tables.initialized) return;
+    memset(&tm_decode_tables, TM_DECODE_INVALID, sizeof(tm_decode_tables));
+    for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+        tm_decode_tables.write[INT_TO_NUMERIC(symbol)] = symbol;
+    }
+    tm_decode_tables.write['-'] = 1;
+    tm_decode_tables.dir['L'] = LEFT + 1;
+    tm_decode_tables.dir['R'] = RIGHT + 1;
+    tm_decode_tables.dir['-'] = RIGHT + 1;
+    // Anything past the last state is interpreted as "HALT". This means you could denote it with 'H', '-', or 'Z'
+    for (usize letter = 'A'; letter <= 'Z'; letter++) {
+        tm_decode_tables.next_state[letter] = (letter - 'A' < STATES) ? (u8)(letter - 'A') : (u8)HALT_STATE;
+    }
+    tm_decode_tables.next_state['-'] = (u8)HALT_STATE;
+    tm_decode_tables.initialized = true;
+}
+
+/// Table driven counterpart to parse_machine for codes with exactly TM_CODE_LENGTH characters and no terminator.
+/// Assumes valid memory address to write to.
+_TMCodeParseError parse_machine_fixed_width(Machine OUT_machine, const String code) {
+    if (code.length > TM_CODE_LENGTH) return TOO_LONG;
+    if (code.length < TM_CODE_LENGTH) return TOO_SHORT;
+    tm_decode_tables_init();
+
+    const u8* chars = (const u8*)code.str;
+    for (usize state = 0; state < STATES; state++) {
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++, chars += 3) {
+            u8 write = tm_decode_tables.write[chars[0]];
+            u8 dir = tm_decode_tables.dir[chars[1]];
+            u8 next_state = tm_decode_tables.next_state[chars[2]];
+            if (write == TM_DECODE_INVALID) return INVALID_FORMAT_WRITE;
+            if (dir == TM_DECODE_INVALID) return INVALID_FORMAT_DIR;
+            if (next_state == TM_DECODE_INVALID) return BROKEN_FORMAT_GENERIC;
+            Instruction instruction = {write, (Direction)dir - 1, next_state};
+            OUT_machine[state][symbol] = instruction;
+        }
+        if (state + 1 < STATES && *(chars++) != '_') return BROKEN_FORMAT_GENERIC;
+    }
+    return SUCCESS;
 }
 
-int process_tm_list(const String tm_list) {
-    String current_slice = {.str = tm_list.str, .length = 0};
+/// Writes the standard text form of the machine into OUT_code, including a null terminator.
+/// Halting transitions that match what "---" parses to are written as "---", the rest use 'Z' as the halt state.
+void write_machine_code(const Machine input_machine, char OUT_code[TM_CODE_LENGTH + 1]) {
+    char* out = OUT_code;
+    for (usize state = 0; state < STATES; state++) {
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            Instruction instruction = input_machine[state][symbol];
+            if (instruction.next_state == HALT_STATE && instruction.write == 1 && instruction.dir == RIGHT) {
+                memcpy(out, "---", 3);
+            } else {
+                out[0] = INT_TO_NUMERIC(instruction.write);
+                out[1] = (instruction.dir == RIGHT) ? 'R' : 'L';
+                out[2] = (instruction.next_state == HALT_STATE) ? 'Z' : STATE_TO_CHAR(instruction.next_state);
+            }
+            out += 3;
+        }
+        if (state + 1 < STATES) *(out++) = '_';
+    }
+    *out = '\0';
+}
+
+#define IS_LINE_PADDING(a) (IS_WHITESPACE(a) || (a) == '\r')
+
+/// Finds the end of the line that starts at `start`. Returns the index of its '\n', or the length of the input.
+/// OUT_has_illegal_chars is set if the line contains anything that's neither a TM code char nor whitespace.
+///
+/// With AVX2 the line is scanned 32 bytes at a time. Never allocates.
+usize scan_tm_line(const String input, usize start, bool* OUT_has_illegal_chars) {
+    usize i = start;
+    bool has_illegal_chars = false;
+#ifdef __AVX2__
+    #define BYTE_IN_RANGE(v, low, high) _mm256_and_si256(_mm256_cmpgt_epi8((v), _mm256_set1_epi8((low) - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8((high) + 1), (v)))
+    #define BYTE_EQUALS(v, c) _mm256_cmpeq_epi8((v), _mm256_set1_epi8(c))
+    for (; i + 32 <= input.length; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)&input.str[i]);
+        __m256i valid = _mm256_or_si256(BYTE_IN_RANGE(chunk, '0', '9'), BYTE_IN_RANGE(chunk, 'A', 'Z'));
+        valid = _mm256_or_si256(valid, _mm256_or_si256(BYTE_EQUALS(chunk, '_'), BYTE_EQUALS(chunk, '-')));
+        valid = _mm256_or_si256(valid, _mm256_or_si256(BYTE_EQUALS(chunk, ' '), BYTE_EQUALS(chunk, '\t')));
+        valid = _mm256_or_si256(valid, BYTE_EQUALS(chunk, '\r'));
+        u32 newlines = (u32)_mm256_movemask_epi8(BYTE_EQUALS(chunk, '\n'));
+        u32 illegal = ~(u32)_mm256_movemask_epi8(valid) & ~newlines;
+        if (newlines) {
+            u32 before_newline = (1u << __builtin_ctz(newlines)) - 1;
+            *OUT_has_illegal_chars = has_illegal_chars || (illegal & before_newline);
+            return i + __builtin_ctz(newlines);
+        }
+        has_illegal_chars |= (illegal != 0);
+    }
+    #undef BYTE_IN_RANGE
+    #undef BYTE_EQUALS
+#endif
+    for (; i < input.length && input.str[i] != '\n'; i++) {
+        has_illegal_chars |= !IS_VALID_TM_CODE_CHAR(input.str[i]) && !IS_LINE_PADDING(input.str[i]);
+    }
+    *OUT_has_illegal_chars = has_illegal_chars;
+    return i;
+}
+
+void process_parsing_error(_TMCodeParseError error, usize line_number) {
+    fprintf(stderr, "Skipping line %llu: %s\n", (u64)line_number, parse_error_name(error));
+}
+
+/// Decides every TM code in the list, one per line. Blank lines are ignored.
+/// Malformed lines are reported and skipped. Returns the number of malformed lines.
+/// If counters isn't NULL, progress is added to them. If clock isn't NULL, it is used to time the deciders.
+usize process_tm_list(const String tm_list, ProgressCounters* counters, ProgressClock clock) {
     Machine current_machine = {0};
-    while (true) {
-        while (IS_VALID_TM_CODE_CHAR(END_CHAR_OF_STR(current_slice))) {
-            current_slice.length++;
+    usize malformed_lines = 0;
+    usize line_number = 0;
+    usize position = 0;
+
+    while (position < tm_list.length) {
+        bool has_illegal_chars;
+        usize line_end = scan_tm_line(tm_list, position, &has_illegal_chars);
+        String line = {.str = &tm_list.str[position], .length = line_end - position};
+        usize line_start = position;
+        position = line_end + 1;
+        line_number++;
+        if (counters) {
+            progress_add(&counters->input_bytes, (position < tm_list.length ? position : tm_list.length) - line_start);
         }
 
-        assert("Empty line encountered", current_slice.length);
-        // 3 chars per instruction + 1 underscore separator per state.
-        // Remove this assertion once proper error handling has been introduced.
-        assert("3 chars per instruction + 1 underscore separator per state.", current_slice.length == 3 * (STATES * SYMBOLS) + (STATES-1));
+        while (line.length && IS_LINE_PADDING(line.str[0])) {
+            line.str++;
+            line.length--;
+        }
+        while (line.length && IS_LINE_PADDING(line.str[line.length - 1])) {
+            line.length--;
+        }
+        if (!line.length) continue;
 
-        printf("%.*s\n", current_slice.length, current_slice.str); FLUSH;
+        _TMCodeParseError error = has_illegal_chars ? ILLEGAL_CHARS : parse_machine_fixed_width(current_machine, line);
+        if (error != SUCCESS) {
+            process_parsing_error(error, line_number);
+            malformed_lines++;
+            continue;
+        }
 
-        assert("Parsing machine failed", parse_machine(current_machine, current_slice) == SUCCESS);
-        pipeline(current_machine);
-        current_slice.str = &END_CHAR_OF_STR(current_slice);
-        current_slice.length = 0;
-        
-        while ((current_slice.str < &END_CHAR_OF_STR(tm_list)) && !IS_VALID_TM_CODE_CHAR(END_CHAR_OF_STR(current_slice))) {
-            current_slice.str++;
+        printf("%.*s ", (int)line.length, line.str); FLUSH;
+        DecisionCertificate certificate;
+        u64 pipeline_start = clock ? clock() : 0;
+        DecisionStatus status = pipeline(current_machine, &certificate, counters);
+        if (counters && clock) {
+            progress_add(&counters->busy_nanoseconds, clock() - pipeline_start);
         }
-        if (current_slice.str == &END_CHAR_OF_STR(tm_list)) return 0;
+        printf("%s ", decision_status_name(status));
+        write_certificate(&certificate, stdout);
+        printf("\n"); FLUSH;
     }
+    if (malformed_lines) {
+        fprintf(stderr, "%llu malformed lines skipped\n", (u64)malformed_lines);
+    }
+    return malformed_lines;
 }
 
 /// Reads in the entirety of the contents of a file into memory, returning it as one long malloc string.
@@ -242,11 +473,6 @@ String read_file_unbuffered(FILE* file) {
     return return_string;
 }
 
-typedef enum DecisionStatus {
-    HALTS,      // The machine was proven to halt
-    INFINITE,   // The machine was proven to run forever
-    UNDECIDED,  // The machine could not be decided.
-} DecisionStatus;
 // InstructionInstance* tape_history;
 
 typedef struct Contract {
@@ -262,16 +488,18 @@ typedef enum SimulationInterrupt {
     INTERRUPT_HALT,             // Yay! Machine halted!
     INTERRUPT_UNDEFINED_BLOCK,  // Machine reached a transition it doesn't know how to handle
     INTERRUPT_OUT_OF_MEMORY,    // Ran out of memory
+    INTERRUPT_MAX_STRIDES,      // Ran for the maximum number of strides without any other interrupt
 } SimulationInterrupt;
 
 // Tape: block run_length block run_length
 
 /// Does the actual accelerated simulation of the turing machine. It returns an interrupt when it finishes
+/// executed_strides is both the number of strides already done on entry and the total on exit.
 SimulationInterrupt accelerated_run(const Machine input_machine, TapeState* config,
     const usize max_number_of_strides, usize* executed_strides) {
 
     #define CURRENT_CELL config->tape[config->current_position]
-    for (usize step = *executed_strides; step < max_number_of_strides; step++) {
+    for (; *executed_strides < max_number_of_strides; (*executed_strides)++) {
         Instruction current_instruction = input_machine[config->state][CURRENT_CELL];
         
         if (current_instruction.next_state == HALT_STATE) {
@@ -284,12 +512,18 @@ SimulationInterrupt accelerated_run(const Machine input_machine, TapeState* conf
         CURRENT_CELL = to_write;
         if ((config->current_position == 0 && next_direction == LEFT) ||
             (config->current_position >= config->count - 1 && next_direction == RIGHT)) {
-            return SIMULATION_OUT_OF_MEMORY;
+            return INTERRUPT_OUT_OF_MEMORY;
         }
         config->current_position += next_direction;
         config->state = next_state;
+        if (config->min_visited > config->current_position) {
+            config->min_visited = config->current_position;
+        }
+        if (config->max_visited < config->current_position) {
+            config->max_visited = config->current_position;
+        }
     }
-    return SIMULATION_MAX_STEPS;
+    return INTERRUPT_MAX_STRIDES;
     #undef CURRENT_CELL
 }
 
@@ -403,23 +637,166 @@ RLETapeState run_length_collapse_raw_to_rle(const TapeState config, RLBlock coll
 /// A block definition is an array of blocks {{A, *}, {B, *}, {C, 2*}, {1, 3}}
 ///
 /// The definition needs to specify if it's an exact amount or a stand in for "unbounded". Let -1 be the value of an unbounded number of blocks
+///
+/// Block definitions are hash-consed: every distinct block array is stored once, so two block IDs are equal
+/// if and only if the blocks are equal. IDs below SYMBOLS are reserved for the raw tape symbols.
+/// A definition only refers to IDs that were interned before it, so sub-blocks always have smaller IDs.
 typedef struct BlockDefinition {
     RelativeArenaPtr block_array;
     usize array_size;
+    u64 hash;
 } BlockDefinition;
 
+#define BLOCK_ID_EVICTED (u32)(-1)
 
 typedef struct FatStruct {
-    const Machine machine;
+    const Instruction (*machine)[SYMBOLS];
     Arena scratch_arena;
-    Arena block_definitions_arena;
+    Arena block_definitions_arena; // BlockDefinition array indexed by block ID
+    Arena block_arrays_arena;      // The contents of every block definition
+    Arena block_table_arena;       // Open addressing hash table of (block ID + 1). 0 is an empty slot.
     Arena run_length_tape_arena;
     RLETapeState* tape_state;
-    BlockDefinition* block_definitions_array;
-    Block* block_arrays;
-
+    usize block_definition_count;
+    usize block_table_capacity;    // Always a power of 2
 } ExecutionContext, SimulationContext;
 
+// The arenas can move when they grow, so these have to be looked up again after any allocation.
+#define BLOCK_DEFINITIONS(context) ((BlockDefinition*)(context)->block_definitions_arena.bytes)
+#define BLOCK_ARRAY(context, definition) ((Block*)&(context)->block_arrays_arena.bytes[(definition).block_array])
+#define BLOCK_TABLE(context) ((u32*)(context)->block_table_arena.bytes)
+
+u64 block_array_hash(const Block* blocks, usize count) {
+    u64 hash = 14695981039346656037ULL; // FNV-1a, one round per field
+    for (usize i = 0; i < count; i++) {
+        hash = (hash ^ blocks[i].block) * 1099511628211ULL;
+        hash = (hash ^ blocks[i].run_length) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// For internal usage only. Writes the ID into the first free slot of its hash chain.
+void _block_table_insert(ExecutionContext* context, u64 hash, u32 block_id) {
+    u32* table = BLOCK_TABLE(context);
+    usize mask = context->block_table_capacity - 1;
+    usize slot = hash & mask;
+    while (table[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    table[slot] = block_id + 1;
+}
+
+/// For internal usage only. Throws away the hash table and reinserts every definition.
+void _block_table_rebuild(ExecutionContext* context, usize capacity) {
+    afree(&context->block_table_arena);
+    context->block_table_arena = arena_init(capacity * sizeof(u32) + 1);
+    aalloc_zero(&context->block_table_arena, capacity * sizeof(u32));
+    context->block_table_capacity = capacity;
+    for (usize id = 0; id < context->block_definition_count; id++) {
+        _block_table_insert(context, BLOCK_DEFINITIONS(context)[id].hash, id);
+    }
+}
+
+/// Returns the ID of the block definition with the given contents, creating it if it doesn't exist yet.
+u32 intern_block_definition(ExecutionContext* context, const Block* blocks, usize count) {
+    u64 hash = block_array_hash(blocks, count);
+    u32* table = BLOCK_TABLE(context);
+    usize mask = context->block_table_capacity - 1;
+    for (usize slot = hash & mask; table[slot]; slot = (slot + 1) & mask) {
+        u32 id = table[slot] - 1;
+        BlockDefinition definition = BLOCK_DEFINITIONS(context)[id];
+        if (definition.hash == hash && definition.array_size == count &&
+            !memcmp(BLOCK_ARRAY(context, definition), blocks, count * sizeof(Block))) {
+            return id;
+        }
+    }
+
+#ifdef DEBUG
+    for (usize i = 0; i < count; i++) {
+        assert("Block definition refers to a block that doesn't exist yet",
+            blocks[i].block < context->block_definition_count || blocks[i].block < SYMBOLS);
+    }
+#endif
+    Block* stored_blocks = aalloc(&context->block_arrays_arena, count * sizeof(Block));
+    memcpy(stored_blocks, blocks, count * sizeof(Block));
+    BlockDefinition* definition = aalloc(&context->block_definitions_arena, sizeof(BlockDefinition));
+    definition->block_array = relative_pointer(context->block_arrays_arena, stored_blocks);
+    definition->array_size = count;
+    definition->hash = hash;
+
+    u32 id = context->block_definition_count++;
+    if (2 * context->block_definition_count > context->block_table_capacity) {
+        _block_table_rebuild(context, context->block_table_capacity * 2);
+    } else {
+        _block_table_insert(context, hash, id);
+    }
+    return id;
+}
+
+/// Evicts every block definition that can't be reached from the blocks on the tape, then renumbers the rest
+/// densely (keeping their order) and rewrites the tape to match.
+/// If OUT_remap isn't NULL, it receives the new ID of every old ID (or BLOCK_ID_EVICTED) so the caller can
+/// rewrite anything else keyed on block IDs, like contracts.
+/// Returns the number of evicted definitions.
+usize compact_block_definitions(ExecutionContext* context, u32* OUT_remap) {
+    usize old_count = context->block_definition_count;
+    usize scratch_mark = context->scratch_arena.number_of_bytes_in_use;
+    u32* remap = aalloc_zero(&context->scratch_arena, old_count * sizeof(u32));
+
+    // Mark everything used on the tape. The raw symbols are always kept.
+    for (usize id = 0; id < SYMBOLS && id < old_count; id++) {
+        remap[id] = true;
+    }
+    RLETapeState* tape_state = context->tape_state;
+    for (usize i = tape_state->min_visited; i <= tape_state->max_visited; i++) {
+        remap[tape_state->tape[i].block] = true;
+    }
+    // Sub-blocks always have smaller IDs than their parents, so a single pass from the top marks everything.
+    for (usize id = old_count; id-- > SYMBOLS;) {
+        if (!remap[id]) continue;
+        BlockDefinition definition = BLOCK_DEFINITIONS(context)[id];
+        Block* blocks = BLOCK_ARRAY(context, definition);
+        for (usize i = 0; i < definition.array_size; i++) {
+            remap[blocks[i].block] = true;
+        }
+    }
+
+    Arena new_definitions_arena = arena_init(context->block_definitions_arena.underlying_allocation_amount);
+    Arena new_arrays_arena = arena_init(context->block_arrays_arena.underlying_allocation_amount);
+    usize new_count = 0;
+    for (usize id = 0; id < old_count; id++) {
+        if (!remap[id]) {
+            remap[id] = BLOCK_ID_EVICTED;
+            continue;
+        }
+        remap[id] = new_count++;
+        BlockDefinition definition = BLOCK_DEFINITIONS(context)[id];
+        Block* blocks = aalloc(&new_arrays_arena, definition.array_size * sizeof(Block));
+        memcpy(blocks, BLOCK_ARRAY(context, definition), definition.array_size * sizeof(Block));
+        for (usize i = 0; i < definition.array_size; i++) {
+            blocks[i].block = remap[blocks[i].block];
+        }
+        definition.block_array = relative_pointer(new_arrays_arena, blocks);
+        definition.hash = block_array_hash(blocks, definition.array_size);
+        *(BlockDefinition*)aalloc(&new_definitions_arena, sizeof(BlockDefinition)) = definition;
+    }
+    afree(&context->block_definitions_arena);
+    afree(&context->block_arrays_arena);
+    context->block_definitions_arena = new_definitions_arena;
+    context->block_arrays_arena = new_arrays_arena;
+    context->block_definition_count = new_count;
+    _block_table_rebuild(context, context->block_table_capacity);
+
+    for (usize i = tape_state->min_visited; i <= tape_state->max_visited; i++) {
+        tape_state->tape[i].block = remap[tape_state->tape[i].block];
+    }
+    if (OUT_remap) {
+        memcpy(OUT_remap, remap, old_count * sizeof(u32));
+    }
+    context->scratch_arena.number_of_bytes_in_use = scratch_mark;
+    return old_count - new_count;
+}
+
 /// Initializes the fat struct for the accelerated simulation
 /// Initializes all of the memory arenas and the blank tape state
 ExecutionContext accelerated_simulation_init(const Machine input_machine) {
@@ -427,9 +804,11 @@ ExecutionContext accelerated_simulation_init(const Machine input_machine) {
 
     new_context.scratch_arena           = arena_init(4096);
     new_context.block_definitions_arena = arena_init(sizeof(BlockDefinition) * 4096);
-    new_context.run_length_tape_arena   = arena_init(4096 * sizeof(*new_context.tape_state->tape) + sizeof(new_context.tape_state));
+    new_context.block_arrays_arena      = arena_init(sizeof(Block) * 4096);
+    // aalloc grows an arena as soon as it would be completely full, hence the extra byte.
+    new_context.run_length_tape_arena   = arena_init(4096 * sizeof(*new_context.tape_state->tape) + sizeof(*new_context.tape_state) + 1);
 
-    new_context.tape_state = aalloc(&new_context.run_length_tape_arena, sizeof(new_context.tape_state));
+    new_context.tape_state = aalloc(&new_context.run_length_tape_arena, sizeof(*new_context.tape_state));
 
     new_context.tape_state->count = 4096;
     new_context.tape_state->current_position = new_context.tape_state->count / 2;
@@ -438,12 +817,11 @@ ExecutionContext accelerated_simulation_init(const Machine input_machine) {
     new_context.tape_state->state = 0;
     new_context.tape_state->tape = aalloc_zero(&new_context.run_length_tape_arena, 4096 * sizeof(*new_context.tape_state->tape));
 
-    new_context.block_definitions_array = aalloc_zero(&new_context.block_definitions_arena, sizeof(BlockDefinition) * 4096);
-    // Block zero_block = {0, ANY_LENGTH};
-    // Block one_block  = {1, ANY_LENGTH};
-    // new_context.block_arrays[0] = zero_block;
-    // new_context.block_arrays[1] = one_block;
-    new_context.block_definitions_array[0] = 
+    _block_table_rebuild(&new_context, 64);
+    for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+        Block symbol_block = {symbol, 1};
+        intern_block_definition(&new_context, &symbol_block, 1);
+    }
 
     return new_context;
 }
@@ -453,6 +831,8 @@ ExecutionContext accelerated_simulation_close(ExecutionContext context) {
     afree(&context.run_length_tape_arena); context.run_length_tape_arena = null_arena;
     afree(&context.scratch_arena); context.scratch_arena = null_arena;
     afree(&context.block_definitions_arena); context.block_definitions_arena = null_arena;
+    afree(&context.block_arrays_arena); context.block_arrays_arena = null_arena;
+    afree(&context.block_table_arena); context.block_table_arena = null_arena;
     ExecutionContext null_context = {0};
     return null_context;
 }
@@ -8,9 +8,15 @@
 #define DEBUG
 
 #include "inductive_decider.c"
+#include "progress_reporter.c"
 
 void help_menu() {
-    // TODO: Implement help menu
+    fprintf(stderr,
+        "Usage: ./<exe> <input file> <params>\n"
+        "Params:\n"
+        "\t-progress <seconds>\tHow often to report progress. 0 turns reporting off. Defaults to 10.\n"
+        "\t-status <file>\t\tWrite progress reports to <file> instead of stderr.\n"
+    );
 }
 
 /// Reads in command line arguments. Standard main function stuff.
@@ -25,6 +31,19 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    ProgressOptions progress_options = {.interval_seconds = 10, .status_file = NULL};
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "-progress") && i + 1 < argc) {
+            progress_options.interval_seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-status") && i + 1 < argc) {
+            progress_options.status_file = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown parameter %s\n", argv[i]);
+            help_menu();
+            return 0;
+        }
+    }
+
     FILE* in = fopen(argv[1], "rb");
 
     assert("Reading input file failed (does the file exist?)", in);
@@ -34,7 +53,12 @@ int main(int argc, char* argv[]) {
     assert("Unknown error", file_contents.str > 0);
     assert("Cannot process empty file - This is usually a bug", file_contents.length);
 
-    process_tm_list(file_contents);
+    ProgressCounters counters = {0};
+    ProgressReporter reporter;
+    progress_reporter_start(&reporter, progress_options, &counters, 1, file_contents.length);
+    // Without a reporter nobody reads the decider timings, so the clock isn't needed
+    process_tm_list(file_contents, &counters, progress_options.interval_seconds > 0 ? monotonic_nanoseconds : NULL);
+    progress_reporter_stop(&reporter);
 
     free(file_contents.str);
     return 0;
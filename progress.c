@@ -0,0 +1,29 @@
+// Progress counters for long batch runs.
+//
+// Every worker owns one ProgressCounters and is the only thread that writes to it. Counters are updated with
+// relaxed atomic stores instead of read-modify-write operations, so the workers never contend on a cache line
+// lock. Reading them and reporting on them lives in progress_reporter.c, so the deciders themselves only need
+// the standard library.
+
+#include <stdatomic.h>
+
+typedef struct ProgressCounters {
+    _Atomic u64 machines;
+    _Atomic u64 verdicts[UNDECIDED + 1];
+    _Atomic u64 steps;
+    _Atomic u64 input_bytes;     // Bytes of the input this worker has consumed. Summed over the workers.
+    _Atomic u64 busy_nanoseconds; // Time spent inside the deciders
+} __attribute__((aligned(64))) ProgressCounters; // One cache line per worker, so workers don't share lines
+
+/// Returns the current time in nanoseconds. Supplied by whoever reports progress, so the core doesn't need a clock.
+typedef u64 (*ProgressClock)();
+
+/// Adds to a counter owned by the calling worker. Only safe because every counter has a single writer.
+void progress_add(_Atomic u64* counter, u64 amount) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+void progress_set(_Atomic u64* counter, u64 value) {
+    atomic_store_explicit(counter, value, memory_order_relaxed);
+}
+
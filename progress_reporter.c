@@ -0,0 +1,145 @@
+// Progress and throughput reporting for long batch runs.
+//
+// A reporter thread samples the ProgressCounters of every worker at a fixed interval and writes a one line
+// summary to stderr or to a status file. This needs POSIX threads and a monotonic clock, so only the batch
+// entry point includes it.
+
+#include <pthread.h>
+#include <time.h>
+
+#ifndef PROGRESS_MAX_WORKERS
+    #define PROGRESS_MAX_WORKERS 64
+#endif
+#define PROGRESS_WINDOW_SAMPLES 8 // Rates are averaged over this many report intervals
+
+typedef struct ProgressOptions {
+    double interval_seconds; // 0 disables the reporter
+    const char* status_file; // NULL writes the reports to stderr
+} ProgressOptions;
+
+typedef struct ProgressSample {
+    double time;
+    u64 machines;
+    u64 steps;
+    u64 input_bytes;
+    u64 busy_nanoseconds[PROGRESS_MAX_WORKERS];
+} ProgressSample;
+
+typedef struct ProgressReporter {
+    ProgressOptions options;
+    ProgressCounters* counters;
+    usize worker_count;
+    u64 input_length;
+    double start_time;
+    _Atomic bool stop;
+    pthread_t thread;
+    ProgressSample window[PROGRESS_WINDOW_SAMPLES];
+    usize sample_count;
+} ProgressReporter;
+
+u64 monotonic_nanoseconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u64)now.tv_sec * 1000000000ULL + (u64)now.tv_nsec;
+}
+
+u64 progress_read(_Atomic u64* counter) {
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+ProgressSample progress_take_sample(ProgressReporter* reporter) {
+    ProgressSample sample = {.time = monotonic_nanoseconds() * 1e-9};
+    for (usize i = 0; i < reporter->worker_count; i++) {
+        ProgressCounters* counters = &reporter->counters[i];
+        sample.machines += progress_read(&counters->machines);
+        sample.steps += progress_read(&counters->steps);
+        sample.input_bytes += progress_read(&counters->input_bytes);
+        sample.busy_nanoseconds[i] = progress_read(&counters->busy_nanoseconds);
+    }
+    return sample;
+}
+
+void progress_write_report(ProgressReporter* reporter) {
+    ProgressSample sample = progress_take_sample(reporter);
+    // Rates come from the oldest sample still in the sliding window
+    ProgressSample oldest = {.time = reporter->start_time};
+    if (reporter->sample_count >= PROGRESS_WINDOW_SAMPLES) {
+        oldest = reporter->window[reporter->sample_count % PROGRESS_WINDOW_SAMPLES];
+    } else if (reporter->sample_count) {
+        oldest = reporter->window[0];
+    }
+    reporter->window[reporter->sample_count % PROGRESS_WINDOW_SAMPLES] = sample;
+    reporter->sample_count++;
+
+    double elapsed = sample.time - oldest.time;
+    if (elapsed <= 0) elapsed = 1e-9;
+    double machine_rate = (sample.machines - oldest.machines) / elapsed;
+    double step_rate = (sample.steps - oldest.steps) / elapsed;
+    double byte_rate = (sample.input_bytes - oldest.input_bytes) / elapsed;
+
+    u64 verdicts[UNDECIDED + 1] = {0};
+    for (usize i = 0; i < reporter->worker_count; i++) {
+        for (usize status = 0; status <= UNDECIDED; status++) {
+            verdicts[status] += progress_read(&reporter->counters[i].verdicts[status]);
+        }
+    }
+
+    FILE* out = reporter->options.status_file ? fopen(reporter->options.status_file, "w") : stderr;
+    if (!out) return; // A status file that can't be written shouldn't stop the run
+    fprintf(out, "[progress] %llu machines (%llu halt, %llu infinite, %llu undecided) | %.1f machines/s | %.3g steps/s | %.1f%% of input",
+        sample.machines, verdicts[HALTS], verdicts[INFINITE], verdicts[UNDECIDED], machine_rate, step_rate,
+        reporter->input_length ? 100.0 * sample.input_bytes / reporter->input_length : 100.0);
+    if (byte_rate > 0) {
+        u64 eta = (reporter->input_length - sample.input_bytes) / byte_rate;
+        fprintf(out, " | ETA %02llu:%02llu:%02llu", eta / 3600, eta / 60 % 60, eta % 60);
+    }
+    for (usize i = 0; i < reporter->worker_count; i++) {
+        double busy = (sample.busy_nanoseconds[i] - oldest.busy_nanoseconds[i]) * 1e-9;
+        fprintf(out, " | worker %llu %.0f%%", (u64)i, 100.0 * busy / elapsed);
+    }
+    fprintf(out, "\n");
+    if (out == stderr) {
+        fflush(out);
+    } else {
+        fclose(out);
+    }
+}
+
+void* _progress_reporter_thread(void* argument) {
+    ProgressReporter* reporter = argument;
+    double next_report = reporter->start_time + reporter->options.interval_seconds;
+    while (!atomic_load(&reporter->stop)) {
+        // Sleep in short slices so stopping the reporter doesn't wait out a whole interval
+        struct timespec slice = {0, 50 * 1000000};
+        nanosleep(&slice, NULL);
+        if (monotonic_nanoseconds() * 1e-9 >= next_report) {
+            progress_write_report(reporter);
+            next_report += reporter->options.interval_seconds;
+        }
+    }
+    return NULL;
+}
+
+/// Starts the reporter thread. The counters must outlive the reporter. Does nothing if reporting is disabled.
+void progress_reporter_start(ProgressReporter* reporter, ProgressOptions options, ProgressCounters* counters,
+    usize worker_count, u64 input_length) {
+    assert("Too many workers for the progress reporter", worker_count <= PROGRESS_MAX_WORKERS);
+    ProgressReporter new_reporter = {
+        .options = options,
+        .counters = counters,
+        .worker_count = worker_count,
+        .input_length = input_length,
+        .start_time = monotonic_nanoseconds() * 1e-9,
+    };
+    *reporter = new_reporter;
+    if (options.interval_seconds <= 0) return;
+    assert("Failed to start the progress reporter", !pthread_create(&reporter->thread, NULL, _progress_reporter_thread, reporter));
+}
+
+/// Stops the reporter thread and writes one final report.
+void progress_reporter_stop(ProgressReporter* reporter) {
+    if (reporter->options.interval_seconds <= 0) return;
+    atomic_store(&reporter->stop, true);
+    pthread_join(reporter->thread, NULL);
+    progress_write_report(reporter);
+}
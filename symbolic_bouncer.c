@@ -0,0 +1,217 @@
+// Bouncer decider with symbolic run lengths.
+//
+// The tape is stored run length encoded on both sides of the head, and a run can have a symbolic length
+// (x)^(a + b*n). The machine is simulated normally, and every time the head visits a new cell the tape is
+// compared to the last time the same state broke a record on the same side. If the two tapes have the same
+// runs and only the run lengths grew, they are treated as C(0) and C(1) of a family C(n), where each run grows by
+// the difference.
+//
+// C(n) is then simulated symbolically for an unknown n >= 0. Whenever the head meets a run it would sweep
+// through in a single state, the whole run is crossed at once no matter how long it is. If the simulation reaches
+// exactly C(n + 1), then C(0) -> C(1) -> C(2) -> ... and the machine never halts.
+//
+// This covers bouncers and translated cyclers. Binary counters grow exponentially rather than linearly,
+// so only the ones whose records happen to look linear are caught.
+
+#ifndef SYMBOLIC_MAX_RUNS
+    #define SYMBOLIC_MAX_RUNS 64
+#endif
+#ifndef SYMBOLIC_PROOF_MAX_STEPS
+    #define SYMBOLIC_PROOF_MAX_STEPS 10000
+#endif
+#ifndef SYMBOLIC_BOUNCER_STEPS
+    #define SYMBOLIC_BOUNCER_STEPS 8192
+#endif
+
+typedef struct SymbolicBlock {
+    usize block;
+    i64 run_length; // The length when n = 0. Always at least 1, so a run is never empty.
+    i64 growth;     // How much the length grows every time n goes up by one
+} SymbolicBlock;
+
+/// Both halves of the tape are stacks, with the run next to the head on top (at index count - 1).
+/// The blank cells past the bottom of a stack aren't stored, so the bottom run is never blank.
+typedef struct SymbolicTape {
+    SymbolicBlock left[SYMBOLIC_MAX_RUNS];
+    SymbolicBlock right[SYMBOLIC_MAX_RUNS];
+    usize left_count;
+    usize right_count;
+    usize head_symbol;
+    int state;
+} SymbolicTape;
+
+/// Pushes a run onto one half of the tape, merging it into the top run if the symbols match.
+/// Returns false if the half is full.
+bool symbolic_push(SymbolicBlock* stack, usize* count, SymbolicBlock run) {
+    if (*count == 0 && run.block == 0) return true;
+    if (*count && stack[*count - 1].block == run.block) {
+        stack[*count - 1].run_length += run.run_length;
+        stack[*count - 1].growth += run.growth;
+        return true;
+    }
+    if (*count == SYMBOLIC_MAX_RUNS) return false;
+    stack[(*count)++] = run;
+    return true;
+}
+
+/// Takes the cell next to the head off one half of the tape.
+/// Returns false if that can't be done for every n, which is when a run of length 1 + b*n has to be split.
+bool symbolic_pop_cell(SymbolicBlock* stack, usize* count, usize* OUT_symbol) {
+    if (*count == 0) {
+        *OUT_symbol = 0;
+        return true;
+    }
+    SymbolicBlock* top = &stack[*count - 1];
+    *OUT_symbol = top->block;
+    if (top->run_length > 1) {
+        top->run_length--;
+        return true;
+    }
+    if (top->growth) return false;
+    (*count)--;
+    return true;
+}
+
+/// Run length encodes the visited part of a raw tape. Every run gets a growth of 0.
+/// Returns false if the tape has more than SYMBOLIC_MAX_RUNS runs on one side.
+bool symbolic_tape_from_config(const TapeState* config, SymbolicTape* OUT_tape) {
+    OUT_tape->left_count = 0;
+    OUT_tape->right_count = 0;
+    for (usize i = config->min_visited; i < config->current_position; i++) {
+        SymbolicBlock cell = {config->tape[i], 1, 0};
+        if (!symbolic_push(OUT_tape->left, &OUT_tape->left_count, cell)) return false;
+    }
+    for (usize i = config->max_visited; i > config->current_position; i--) {
+        SymbolicBlock cell = {config->tape[i], 1, 0};
+        if (!symbolic_push(OUT_tape->right, &OUT_tape->right_count, cell)) return false;
+    }
+    OUT_tape->head_symbol = config->tape[config->current_position];
+    OUT_tape->state = config->state;
+    return true;
+}
+
+bool symbolic_tapes_equal(const SymbolicTape* a, const SymbolicTape* b) {
+    return a->state == b->state && a->head_symbol == b->head_symbol &&
+        a->left_count == b->left_count && a->right_count == b->right_count &&
+        !memcmp(a->left, b->left, a->left_count * sizeof(SymbolicBlock)) &&
+        !memcmp(a->right, b->right, a->right_count * sizeof(SymbolicBlock));
+}
+
+/// Simulates the family of configurations in start symbolically. Returns true if it provably reaches start with
+/// n + 1 in place of n (or sweeps off into the blank tape forever), which means the machine never halts.
+bool symbolic_prove_bouncer(const Machine input_machine, const SymbolicTape* start) {
+    SymbolicTape goal = *start;
+    for (usize i = 0; i < goal.left_count; i++) goal.left[i].run_length += goal.left[i].growth;
+    for (usize i = 0; i < goal.right_count; i++) goal.right[i].run_length += goal.right[i].growth;
+
+    SymbolicTape tape = *start;
+    for (usize step = 0; step < SYMBOLIC_PROOF_MAX_STEPS; step++) {
+        Instruction instruction = input_machine[tape.state][tape.head_symbol];
+        if (instruction.next_state == HALT_STATE) return false;
+
+        SymbolicBlock* ahead = (instruction.dir == RIGHT) ? tape.right : tape.left;
+        usize* ahead_count = (instruction.dir == RIGHT) ? &tape.right_count : &tape.left_count;
+        SymbolicBlock* behind = (instruction.dir == RIGHT) ? tape.left : tape.right;
+        usize* behind_count = (instruction.dir == RIGHT) ? &tape.left_count : &tape.right_count;
+        bool self_loop = instruction.next_state == tape.state;
+
+        if (self_loop && *ahead_count == 0 && tape.head_symbol == 0) {
+            return true; // Sweeps into the blank tape and never comes back
+        }
+        SymbolicBlock written = {instruction.write, 1, 0};
+        if (self_loop && *ahead_count && ahead[*ahead_count - 1].block == tape.head_symbol) {
+            // Shift rule: the head crosses the whole run in the same state, whatever its length is.
+            SymbolicBlock run = ahead[--(*ahead_count)];
+            written.run_length += run.run_length;
+            written.growth = run.growth;
+        }
+        if (!symbolic_push(behind, behind_count, written)) return false;
+        if (!symbolic_pop_cell(ahead, ahead_count, &tape.head_symbol)) return false;
+        tape.state = instruction.next_state;
+
+        if (symbolic_tapes_equal(&tape, &goal)) return true;
+    }
+    return false;
+}
+
+/// Treats two snapshots of the same machine as C(0) and C(1), and tries to prove C(n) -> C(n + 1).
+bool symbolic_bouncer_check(const Machine input_machine, const SymbolicTape* previous, const SymbolicTape* current) {
+    if (previous->state != current->state || previous->head_symbol != current->head_symbol ||
+        previous->left_count != current->left_count || previous->right_count != current->right_count) {
+        return false;
+    }
+    SymbolicTape start = *current;
+    for (usize i = 0; i < start.left_count; i++) {
+        if (previous->left[i].block != current->left[i].block) return false;
+        start.left[i].growth = current->left[i].run_length - previous->left[i].run_length;
+        if (start.left[i].growth < 0) return false;
+    }
+    for (usize i = 0; i < start.right_count; i++) {
+        if (previous->right[i].block != current->right[i].block) return false;
+        start.right[i].growth = current->right[i].run_length - previous->right[i].run_length;
+        if (start.right[i].growth < 0) return false;
+    }
+    return symbolic_prove_bouncer(input_machine, &start);
+}
+
+typedef struct SymbolicRecord {
+    SymbolicTape tape;
+    usize step;
+    bool valid;
+} SymbolicRecord;
+
+/// Simulates the machine for up to max_steps steps looking for a bouncer. On success OUT_steps receives the two
+/// step counts whose configurations were used as C(0) and C(1), which is enough to check the proof again.
+/// OUT_simulated_steps receives the number of steps simulated, whether or not a bouncer was found.
+DecisionStatus decide_symbolic_bouncer(const Machine input_machine, usize max_steps, usize OUT_steps[2], usize* OUT_simulated_steps) {
+    TapeState tape_state = tape_state_init(2 * max_steps + 3);
+    // Records are kept per state and per side (0 for left, 1 for right)
+    Arena record_arena = arena_init(sizeof(SymbolicRecord) * STATES * 2 + sizeof(SymbolicTape) + 1);
+    SymbolicRecord* records = aalloc_zero(&record_arena, sizeof(SymbolicRecord) * STATES * 2);
+    SymbolicTape* current = aalloc(&record_arena, sizeof(SymbolicTape));
+
+    DecisionStatus status = UNDECIDED;
+    *OUT_simulated_steps = 0;
+    for (usize step = 1; step <= max_steps; step++) {
+        usize old_min_visited = tape_state.min_visited;
+        usize old_max_visited = tape_state.max_visited;
+        *OUT_simulated_steps = step;
+        if (simulate_unaccelerated(input_machine, &tape_state, 1) != SIMULATION_MAX_STEPS) break;
+        if (tape_state.min_visited == old_min_visited && tape_state.max_visited == old_max_visited) continue;
+
+        SymbolicRecord* record = &records[tape_state.state * 2 + (tape_state.max_visited != old_max_visited)];
+        if (!symbolic_tape_from_config(&tape_state, current)) {
+            record->valid = false;
+            continue;
+        }
+        if (record->valid && symbolic_bouncer_check(input_machine, &record->tape, current)) {
+            OUT_steps[0] = record->step;
+            OUT_steps[1] = step;
+            status = INFINITE;
+            break;
+        }
+        record->tape = *current;
+        record->step = step;
+        record->valid = true;
+    }
+    afree(&record_arena);
+    free(tape_state.tape);
+    return status;
+}
+
+/// Checks a bouncer found by decide_symbolic_bouncer, given the two step counts it reported.
+/// Step counts the decider could never have reported are rejected before anything is allocated.
+bool symbolic_bouncer_verify(const Machine input_machine, usize first_step, usize second_step) {
+    if (first_step >= second_step || second_step > SYMBOLIC_BOUNCER_STEPS) return false;
+    TapeState tape_state = tape_state_init(2 * second_step + 3);
+    SymbolicTape* snapshots = calloc(2, sizeof(SymbolicTape));
+    bool verified = tape_state.tape && snapshots &&
+        simulate_unaccelerated(input_machine, &tape_state, first_step) == SIMULATION_MAX_STEPS &&
+        symbolic_tape_from_config(&tape_state, &snapshots[0]) &&
+        simulate_unaccelerated(input_machine, &tape_state, second_step - first_step) == SIMULATION_MAX_STEPS &&
+        symbolic_tape_from_config(&tape_state, &snapshots[1]) &&
+        symbolic_bouncer_check(input_machine, &snapshots[0], &snapshots[1]);
+    free(snapshots);
+    free(tape_state.tape);
+    return verified;
+}
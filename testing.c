@@ -8,6 +8,9 @@
 #define DEBUG
 
 #include "inductive_decider.c"
+#include "progress_reporter.c"
+#include <pthread.h>
+#include <unistd.h>
 
 void test_parsing() {
     Machine result = {0};
@@ -52,6 +55,52 @@ void test_parsing() {
     fprintf(stderr, "Parsing tests passed\n");
 }
 
+void test_tm_list_scanning() {
+    char* list = "1RB0RA_1LC1LF_1RD0LB_1RA1LE_---0LC_1RG1LD_0RG0RF\r\n"
+                 "\n"
+                 "1RB0RA_1LC1LF_1RD0LB_1RA1LE_---0LC_1RG1LD_0RG0R!\n"
+                 "  1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA_------_------";
+    String tm_list = {list, strlen(list)};
+    bool has_illegal_chars = true;
+
+    usize first_end = scan_tm_line(tm_list, 0, &has_illegal_chars);
+    assert("Wrong end of line", first_end == TM_CODE_LENGTH + 1);
+    assert("Carriage return treated as illegal", !has_illegal_chars);
+    assert("Empty line not found", scan_tm_line(tm_list, first_end + 1, &has_illegal_chars) == first_end + 1);
+    usize third_end = scan_tm_line(tm_list, first_end + 2, &has_illegal_chars);
+    assert("Wrong end of line", third_end == first_end + 2 + TM_CODE_LENGTH);
+    assert("Illegal char not found", has_illegal_chars);
+    assert("Last line should end at the end of the input", scan_tm_line(tm_list, third_end + 1, &has_illegal_chars) == tm_list.length);
+    assert("Leading whitespace treated as illegal", !has_illegal_chars);
+
+    Machine table_machine = {0};
+    Machine reference_machine = {0};
+    String code = {list, TM_CODE_LENGTH};
+    assert("Fixed width parse failed", parse_machine_fixed_width(table_machine, code) == SUCCESS);
+    assert("Parsing failed", parse_machine(reference_machine, code) == SUCCESS);
+    for (usize state = 0; state < STATES; state++) {
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            Instruction table_instruction = table_machine[state][symbol];
+            Instruction reference_instruction = reference_machine[state][symbol];
+            assert("Fixed width parse disagrees with parse_machine",
+                table_instruction.write == reference_instruction.write &&
+                table_instruction.dir == reference_instruction.dir &&
+                table_instruction.next_state == reference_instruction.next_state);
+        }
+    }
+
+    String short_code = {list, TM_CODE_LENGTH - 1};
+    assert("Short code accepted", parse_machine_fixed_width(table_machine, short_code) == TOO_SHORT);
+    String bad_write = {"9RB0RA_1LC1LF_1RD0LB_1RA1LE_---0LC_1RG1LD_0RG0RF", TM_CODE_LENGTH};
+    assert("Out of range symbol accepted", parse_machine_fixed_width(table_machine, bad_write) == INVALID_FORMAT_WRITE);
+    String bad_dir = {"1SB0RA_1LC1LF_1RD0LB_1RA1LE_---0LC_1RG1LD_0RG0RF", TM_CODE_LENGTH};
+    assert("Bad direction accepted", parse_machine_fixed_width(table_machine, bad_dir) == INVALID_FORMAT_DIR);
+    String bad_separator = {"1RB0RA-1LC1LF_1RD0LB_1RA1LE_---0LC_1RG1LD_0RG0RF", TM_CODE_LENGTH};
+    assert("Bad separator accepted", parse_machine_fixed_width(table_machine, bad_separator) == BROKEN_FORMAT_GENERIC);
+
+    fprintf(stderr, "TM list scanning tests passed\n");
+}
+
 void test_unaccelerated_running() {
     String test_string = {"1RA0RA_1LC1LF_1RD0LB_1RA1LE_---0LC_1RG1LD_0RG0RF", sizeof("1RA0RA_1LC1LF_1RD0LB_1RA1LE_---0LC_1RG1LD_0RG0RF")};
     Machine tc_machine = {0};
@@ -149,14 +198,446 @@ void test_rle_collapse() {
     fprintf(stderr, "Simple rle tests passed\n");
 }
 
+void test_closed_tape_language() {
+    String runaway_string = {"1RA---_------_------_------_------_------_------", sizeof("1RA---_------_------_------_------_------_------")};
+    Machine runaway_machine = {0};
+    assert("Parsing failed", parse_machine(runaway_machine, runaway_string) == SUCCESS);
+    ClosedTapeLanguageCertificate certificate = {0};
+    assert("Failed to decide a machine that runs right forever", decide_closed_tape_language(runaway_machine, &certificate) == INFINITE);
+    // The right half of the tape has to be known to be blank, which takes 2 DFA states
+    assert("Certificate has the wrong size", certificate.right.state_count == 2);
+
+    String bb5_champ_string = {"1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA_------_------", sizeof("1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA_------_------")};
+    Machine test_bb5_champ = {0};
+    assert("Parsing BB5 champ failed", parse_machine(test_bb5_champ, bb5_champ_string) == SUCCESS);
+    assert("Halting machine was decided as infinite", decide_closed_tape_language(test_bb5_champ, NULL) == UNDECIDED);
+
+    fprintf(stderr, "Closed tape language tests passed\n");
+}
+
+void test_backward_reasoning() {
+    String refutable_string = {"1LB1LD_1LD1RB_0RZ0RB_1RB1LC_------_------_------", sizeof("1LB1LD_1LD1RB_0RZ0RB_1RB1LC_------_------_------")};
+    Machine refutable_machine = {0};
+    assert("Parsing failed", parse_machine(refutable_machine, refutable_string) == SUCCESS);
+
+    PredecessorIndex index = predecessor_index_init(refutable_machine);
+    usize key = PREDECESSOR_KEY(1, 1); // Entering B after writing a 1: A0, B1 and D0
+    assert("Predecessor index has the wrong number of entries", index.offsets[key + 1] - index.offsets[key] == 3);
+    assert("Predecessor index lost a transition", index.offsets[STATES * SYMBOLS] == 7);
+    assert("Failed to refute a machine whose halting transition can't be reached", decide_backward_reasoning(refutable_machine, NULL) == INFINITE);
+
+    String bb5_champ_string = {"1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA_------_------", sizeof("1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA_------_------")};
+    Machine test_bb5_champ = {0};
+    assert("Parsing BB5 champ failed", parse_machine(test_bb5_champ, bb5_champ_string) == SUCCESS);
+    assert("Halting machine was decided as infinite", decide_backward_reasoning(test_bb5_champ, NULL) == UNDECIDED);
+
+    fprintf(stderr, "Backward reasoning tests passed\n");
+}
+
+void test_block_interning() {
+    Machine empty_machine = {0};
+    ExecutionContext context = accelerated_simulation_init(empty_machine);
+    assert("Raw symbols weren't interned", context.block_definition_count == SYMBOLS);
+
+    Block first_blocks[] = {{0, 1}, {1, ANY_LENGTH}};
+    Block second_blocks[] = {{1, 1}, {0, 2}};
+    u32 first_id = intern_block_definition(&context, first_blocks, 2);
+    u32 second_id = intern_block_definition(&context, second_blocks, 2);
+    assert("Distinct blocks share an ID", first_id != second_id);
+    assert("Equal blocks were stored twice", intern_block_definition(&context, first_blocks, 2) == first_id);
+    Block nested_blocks[] = {{second_id, 3}};
+    u32 nested_id = intern_block_definition(&context, nested_blocks, 1);
+
+    // Enough definitions to force the hash table to grow a few times
+    for (usize i = 0; i < 1000; i++) {
+        Block filler_block = {1, i + 2};
+        intern_block_definition(&context, &filler_block, 1);
+    }
+    assert("Interning lost a definition", context.block_definition_count == SYMBOLS + 3 + 1000);
+    assert("Lookup failed after the table grew", intern_block_definition(&context, second_blocks, 2) == second_id);
+
+    context.tape_state->tape[context.tape_state->current_position].block = nested_id;
+    u32* remap = calloc(context.block_definition_count, sizeof(u32));
+    assert("Compaction evicted the wrong number of blocks", compact_block_definitions(&context, remap) == 1001);
+    assert("Compaction evicted a raw symbol", remap[0] == 0 && remap[1] == 1);
+    assert("Compaction kept an unreferenced block", remap[first_id] == BLOCK_ID_EVICTED);
+    assert("Compaction evicted a sub-block", remap[second_id] == SYMBOLS);
+    assert("Compaction renumbered wrong", remap[nested_id] == SYMBOLS + 1);
+    assert("Tape wasn't rewritten", context.tape_state->tape[context.tape_state->current_position].block == SYMBOLS + 1);
+    Block remapped_nested_blocks[] = {{SYMBOLS, 3}};
+    assert("Sub-block IDs weren't rewritten", intern_block_definition(&context, remapped_nested_blocks, 1) == SYMBOLS + 1);
+    assert("Lookup failed after compaction", intern_block_definition(&context, second_blocks, 2) == SYMBOLS);
+    free(remap);
+
+    accelerated_simulation_close(context);
+    fprintf(stderr, "Block interning tests passed\n");
+}
+
+void test_symbolic_bouncer() {
+    // Pushing merges runs, and blank runs against the blank part of the tape are dropped
+    SymbolicBlock stack[SYMBOLIC_MAX_RUNS];
+    usize count = 0;
+    SymbolicBlock blank_run = {0, 3, 0};
+    SymbolicBlock growing_run = {1, 1, 2};
+    assert("Push failed", symbolic_push(stack, &count, blank_run) && count == 0);
+    assert("Push failed", symbolic_push(stack, &count, growing_run) && count == 1);
+    assert("Push failed", symbolic_push(stack, &count, growing_run) && count == 1);
+    assert("Runs weren't merged", stack[0].run_length == 2 && stack[0].growth == 4);
+    usize symbol;
+    assert("Pop failed", symbolic_pop_cell(stack, &count, &symbol) && symbol == 1 && stack[0].run_length == 1);
+    // (1)^(1 + 4n) might be a single cell or many, so popping another cell can't be done for every n
+    assert("Ambiguous pop allowed", !symbolic_pop_cell(stack, &count, &symbol));
+
+    String bouncer_string = {"1LC1LD_1LA0LD_0RB0LD_1RC1LC_0RZ---_---1LZ_1LZ1LZ", sizeof("1LC1LD_1LA0LD_0RB0LD_1RC1LC_0RZ---_---1LZ_1LZ1LZ")};
+    Machine bouncer_machine = {0};
+    assert("Parsing failed", parse_machine(bouncer_machine, bouncer_string) == SUCCESS);
+    usize steps[2];
+    usize simulated_steps;
+    assert("Failed to decide a bouncer", decide_symbolic_bouncer(bouncer_machine, SYMBOLIC_BOUNCER_STEPS, steps, &simulated_steps) == INFINITE);
+    assert("Wrong number of simulated steps", simulated_steps == steps[1]);
+    assert("Bouncer doesn't verify", symbolic_bouncer_verify(bouncer_machine, steps[0], steps[1]));
+    assert("Wrong bouncer steps accepted", !symbolic_bouncer_verify(bouncer_machine, steps[0], steps[1] - 1));
+    assert("Reversed bouncer steps accepted", !symbolic_bouncer_verify(bouncer_machine, steps[1], steps[0]));
+    assert("Impossible bouncer steps accepted", !symbolic_bouncer_verify(bouncer_machine, 0, (usize)-1));
+
+    String bb5_champ_string = {"1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA_------_------", sizeof("1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA_------_------")};
+    Machine test_bb5_champ = {0};
+    assert("Parsing BB5 champ failed", parse_machine(test_bb5_champ, bb5_champ_string) == SUCCESS);
+    assert("Halting machine was decided as infinite", decide_symbolic_bouncer(test_bb5_champ, SYMBOLIC_BOUNCER_STEPS, steps, &simulated_steps) == UNDECIDED);
+    assert("Wrong number of simulated steps", simulated_steps == SYMBOLIC_BOUNCER_STEPS);
+
+    fprintf(stderr, "Symbolic bouncer tests passed\n");
+}
+
+void test_certificates() {
+    String runaway_string = {"1RA---_------_------_------_------_------_------", sizeof("1RA---_------_------_------_------_------_------")};
+    Machine runaway_machine = {0};
+    assert("Parsing failed", parse_machine(runaway_machine, runaway_string) == SUCCESS);
+    DecisionCertificate certificate;
+    assert("Pipeline failed to decide a machine that runs right forever", pipeline(runaway_machine, &certificate, NULL) == INFINITE);
+    assert("Wrong certificate kind", certificate.kind == CERTIFICATE_CLOSED_TAPE_LANGUAGE);
+    assert("Pipeline certificate doesn't verify", verify_certificate(runaway_machine, INFINITE, &certificate));
+
+    String ctl_text = {"CTL 00 01_11", strlen("CTL 00 01_11")};
+    assert("Failed to parse a CTL certificate", parse_certificate(ctl_text, &certificate));
+    assert("Valid CTL certificate rejected", verify_certificate(runaway_machine, INFINITE, &certificate));
+    assert("CTL certificate accepted for the wrong verdict", !verify_certificate(runaway_machine, HALTS, &certificate));
+    String wrong_ctl_text = {"CTL 00 00", strlen("CTL 00 00")};
+    assert("Failed to parse a CTL certificate", parse_certificate(wrong_ctl_text, &certificate));
+    assert("CTL certificate that isn't closed accepted", !verify_certificate(runaway_machine, INFINITE, &certificate));
+    String malformed_ctl_text = {"CTL 10 01_11", strlen("CTL 10 01_11")};
+    assert("DFA that leaves its start state on blanks accepted", !parse_certificate(malformed_ctl_text, &certificate));
+
+    String bb5_champ_string = {"1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA_------_------", sizeof("1RB1LC_1RC1RB_1RD0LE_1LA1LD_1RZ0LA_------_------")};
+    Machine test_bb5_champ = {0};
+    assert("Parsing BB5 champ failed", parse_machine(test_bb5_champ, bb5_champ_string) == SUCCESS);
+    String halt_text = {"HALT 47176870", strlen("HALT 47176870")};
+    assert("Failed to parse a halting certificate", parse_certificate(halt_text, &certificate));
+    assert("BB5 champ halting certificate rejected", verify_certificate(test_bb5_champ, HALTS, &certificate));
+    certificate.halting_steps--;
+    assert("Wrong halting step count accepted", !verify_certificate(test_bb5_champ, HALTS, &certificate));
+    String huge_halt_text = {"HALT 9999999999999999999", strlen("HALT 9999999999999999999")};
+    assert("Failed to parse a halting certificate", parse_certificate(huge_halt_text, &certificate));
+    assert("Impossible halting step count accepted", !verify_certificate(test_bb5_champ, HALTS, &certificate));
+
+    String refutable_string = {"1LB1LD_1LD1RB_0RZ0RB_1RB1LC_------_------_------", sizeof("1LB1LD_1LD1RB_0RZ0RB_1RB1LC_------_------_------")};
+    Machine refutable_machine = {0};
+    assert("Parsing failed", parse_machine(refutable_machine, refutable_string) == SUCCESS);
+    assert("Pipeline failed to decide a refutable machine", pipeline(refutable_machine, &certificate, NULL) == INFINITE);
+    assert("Wrong certificate kind", certificate.kind == CERTIFICATE_BACKWARD_REASONING);
+    assert("Backward reasoning certificate doesn't verify", verify_certificate(refutable_machine, INFINITE, &certificate));
+
+    String bouncer_string = {"1LC1LD_1LA0LD_0RB0LD_1RC1LC_0RZ---_---1LZ_1LZ1LZ", sizeof("1LC1LD_1LA0LD_0RB0LD_1RC1LC_0RZ---_---1LZ_1LZ1LZ")};
+    Machine bouncer_machine = {0};
+    assert("Parsing failed", parse_machine(bouncer_machine, bouncer_string) == SUCCESS);
+    String bouncer_text = {"BOUNCER 107 131", strlen("BOUNCER 107 131")};
+    assert("Failed to parse a bouncer certificate", parse_certificate(bouncer_text, &certificate));
+    assert("Bouncer certificate rejected", verify_certificate(bouncer_machine, INFINITE, &certificate));
+
+    String trailing_garbage_text = {"HALT 5 6", strlen("HALT 5 6")};
+    assert("Certificate with trailing tokens accepted", !parse_certificate(trailing_garbage_text, &certificate));
+
+    fprintf(stderr, "Certificate tests passed\n");
+}
+
+void test_progress_reporting() {
+    ProgressCounters counters[2] = {0};
+    ProgressOptions options = {.interval_seconds = 60, .status_file = "__progress.txt"};
+    ProgressReporter reporter;
+    progress_reporter_start(&reporter, options, counters, 2, 100);
+
+    progress_add(&counters[0].machines, 2);
+    progress_add(&counters[0].verdicts[INFINITE], 2);
+    progress_add(&counters[1].machines, 1);
+    progress_add(&counters[1].verdicts[HALTS], 1);
+    // Every worker counts the bytes it consumed, so the shares add up
+    progress_add(&counters[0].input_bytes, 20);
+    progress_add(&counters[1].input_bytes, 30);
+    // Stopping writes a final report, so this doesn't have to wait for the interval
+    progress_reporter_stop(&reporter);
+
+    FILE* status_file = fopen("__progress.txt", "rb");
+    assert("Status file wasn't written", status_file);
+    String contents = read_file_unbuffered(status_file);
+    assert("File closing during test failed", !fclose(status_file));
+    char report[512] = {0}; // read_file_unbuffered doesn't null terminate
+    memcpy(report, contents.str, contents.length < sizeof(report) - 1 ? contents.length : sizeof(report) - 1);
+    free(contents.str);
+    char* expected = "[progress] 3 machines (1 halt, 2 infinite, 0 undecided)";
+    assert("Wrong progress report", !strncmp(report, expected, strlen(expected)));
+    assert("Input consumed not reported", strstr(report, "50.0% of input") != NULL);
+    assert("Worker utilization not reported", strstr(report, "worker 1") != NULL);
+    assert("File removal during test failed", !remove("__progress.txt"));
+
+    fprintf(stderr, "Progress reporting tests passed\n");
+}
+
+// Differential testing of every simulation engine against simulate_unaccelerated.
+// The enumerated machines cover every machine with DIFFERENTIAL_ENUMERATED_STATES states (the rest halt),
+// and are followed by DIFFERENTIAL_RANDOM_MACHINES random machines seeded by their index.
+#define DIFFERENTIAL_ENUMERATED_STATES 2
+#define DIFFERENTIAL_RANDOM_MACHINES 20000
+#define DIFFERENTIAL_MAX_STEPS 1000
+#define DIFFERENTIAL_TAPE_WIDTH 1024 // Small enough that some machines run out of tape
+#define DIFFERENTIAL_MAX_THREADS 64
+
+typedef struct EngineResult {
+    TMSimulationResult result;
+    usize steps;
+    TapeState tape; // Owned by the caller, reset before every run
+} EngineResult;
+
+typedef void (*DifferentialEngine)(const Machine input_machine, usize max_steps, EngineResult* OUT_result);
+
+void reference_engine(const Machine input_machine, usize max_steps, EngineResult* OUT_result) {
+    OUT_result->result = SIMULATION_MAX_STEPS;
+    for (OUT_result->steps = 0; OUT_result->steps < max_steps; OUT_result->steps++) {
+        TMSimulationResult result = simulate_unaccelerated(input_machine, &OUT_result->tape, 1);
+        if (result != SIMULATION_MAX_STEPS) {
+            OUT_result->result = result;
+            break;
+        }
+    }
+}
+
+void accelerated_run_engine(const Machine input_machine, usize max_steps, EngineResult* OUT_result) {
+    OUT_result->steps = 0;
+    switch (accelerated_run(input_machine, &OUT_result->tape, max_steps, &OUT_result->steps)) {
+        case INTERRUPT_HALT:          OUT_result->result = SIMULATION_HALTED; break;
+        case INTERRUPT_OUT_OF_MEMORY: OUT_result->result = SIMULATION_OUT_OF_MEMORY; break;
+        case INTERRUPT_MAX_STRIDES:   OUT_result->result = SIMULATION_MAX_STEPS; break;
+        default:                      OUT_result->result = (TMSimulationResult)-1; break;
+    }
+}
+
+/// Runs the reference simulator, then sends the tape through both RLE collapse paths and expands it back.
+/// Collapsing the run the head is in is undefined, so only the tape contents go through the RLE tape.
+void rle_collapse_engine(const Machine input_machine, usize max_steps, EngineResult* OUT_result) {
+    reference_engine(input_machine, max_steps, OUT_result);
+    TapeState* tape = &OUT_result->tape;
+    RLBlock rle_tape[DIFFERENTIAL_TAPE_WIDTH] = {0};
+    RLBlock zero_block = {0, 1};
+    RLBlock one_block = {1, 1};
+    RLETapeState rlets = run_length_collapse_raw_to_rle(*tape, zero_block, rle_tape);
+    run_length_collapse(&rlets, one_block);
+
+    memset(tape->tape, 0, tape->count);
+    usize position = tape->min_visited;
+    for (usize i = rlets.min_visited; i <= rlets.max_visited; i++) {
+        for (usize run = 0; run < rle_tape[i].run_length && position < tape->count; run++) {
+            tape->tape[position++] = rle_tape[i].block;
+        }
+    }
+}
+
+typedef struct NamedEngine {
+    const char* name;
+    DifferentialEngine engine;
+} NamedEngine;
+
+// simulate_accelerated joins this list once it produces results.
+NamedEngine differential_engines[] = {
+    {"accelerated_run", accelerated_run_engine},
+    {"rle_collapse", rle_collapse_engine},
+};
+#define DIFFERENTIAL_ENGINE_COUNT (sizeof(differential_engines) / sizeof(*differential_engines))
+
+void engine_result_reset(EngineResult* result) {
+    memset(result->tape.tape, 0, result->tape.count);
+    result->tape.current_position = result->tape.count / 2;
+    result->tape.min_visited = result->tape.current_position;
+    result->tape.max_visited = result->tape.current_position;
+    result->tape.state = 0;
+    result->steps = 0;
+}
+
+/// Runs the reference and one engine, and returns true if they disagree on anything observable.
+bool engine_diverges(const Machine input_machine, usize max_steps, const NamedEngine* engine,
+    EngineResult* reference, EngineResult* candidate) {
+    engine_result_reset(reference);
+    engine_result_reset(candidate);
+    reference_engine(input_machine, max_steps, reference);
+    engine->engine(input_machine, max_steps, candidate);
+    return reference->result != candidate->result || reference->steps != candidate->steps ||
+        reference->tape.state != candidate->tape.state ||
+        reference->tape.current_position != candidate->tape.current_position ||
+        reference->tape.min_visited != candidate->tape.min_visited ||
+        reference->tape.max_visited != candidate->tape.max_visited ||
+        memcmp(reference->tape.tape, candidate->tape.tape, reference->tape.count);
+}
+
+/// Greedily simplifies a diverging machine (turning transitions into halts, then zeroing their fields)
+/// and returns the smallest step count that still shows the divergence.
+usize shrink_divergence(Machine machine, usize max_steps, const NamedEngine* engine, EngineResult* reference, EngineResult* candidate) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (usize state = 0; state < STATES; state++) {
+            for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+                Instruction original = machine[state][symbol];
+                // Each simplification only moves a field towards a fixed value, so this always terminates.
+                for (usize i = 0; i < 4 && original.next_state != HALT_STATE; i++) {
+                    Instruction simpler = original;
+                    switch (i) {
+                        case 0: simpler.write = 1; simpler.dir = RIGHT; simpler.next_state = HALT_STATE; break;
+                        case 1: simpler.write = 0; break;
+                        case 2: simpler.dir = RIGHT; break;
+                        case 3: simpler.next_state = 0; break;
+                    }
+                    if (simpler.write == original.write && simpler.dir == original.dir && simpler.next_state == original.next_state) continue;
+                    machine[state][symbol] = simpler;
+                    if (engine_diverges(machine, max_steps, engine, reference, candidate)) {
+                        original = simpler;
+                        changed = true;
+                    } else {
+                        machine[state][symbol] = original;
+                    }
+                }
+            }
+        }
+    }
+    for (usize steps = 0; steps < max_steps; steps++) {
+        if (engine_diverges(machine, steps, engine, reference, candidate)) return steps;
+    }
+    return max_steps;
+}
+
+u64 splitmix64(u64 x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+#define DIFFERENTIAL_TRANSITION_CHOICES (SYMBOLS * 2 * (DIFFERENTIAL_ENUMERATED_STATES + 1))
+
+usize differential_enumerated_count() {
+    usize count = 1;
+    for (usize i = 0; i < DIFFERENTIAL_ENUMERATED_STATES * SYMBOLS; i++) {
+        count *= DIFFERENTIAL_TRANSITION_CHOICES;
+    }
+    return count;
+}
+
+/// Writes the machine with the given index. Low indices enumerate machines exhaustively, the rest are random.
+void differential_machine(usize index, Machine OUT_machine) {
+    Instruction halt = {1, RIGHT, HALT_STATE};
+    bool enumerated = index < differential_enumerated_count();
+    usize digits = index;
+    u64 random = splitmix64(index);
+    usize used_states = enumerated ? DIFFERENTIAL_ENUMERATED_STATES : 2 + random % (STATES - 1);
+    for (usize state = 0; state < STATES; state++) {
+        for (usize symbol = 0; symbol < SYMBOLS; symbol++) {
+            OUT_machine[state][symbol] = halt;
+            if (state >= used_states) continue;
+            usize choice;
+            if (enumerated) {
+                choice = digits % DIFFERENTIAL_TRANSITION_CHOICES;
+                digits /= DIFFERENTIAL_TRANSITION_CHOICES;
+            } else {
+                random = splitmix64(random);
+                if (random % 16 == 0) continue; // Roughly one halting transition per random machine
+                choice = random >> 4;
+            }
+            Instruction instruction = {choice % SYMBOLS, (choice / SYMBOLS) % 2 ? RIGHT : LEFT, (choice / SYMBOLS / 2) % (used_states + 1)};
+            if ((usize)instruction.next_state == used_states) instruction.next_state = HALT_STATE;
+            OUT_machine[state][symbol] = instruction;
+        }
+    }
+}
+
+typedef struct DifferentialWorker {
+    pthread_t thread;
+    usize first_index;
+    usize stride;
+    usize machine_count;
+    usize machines_checked;
+    usize divergences;
+} DifferentialWorker;
+
+void* differential_worker(void* argument) {
+    DifferentialWorker* worker = argument;
+    EngineResult reference = {.tape = tape_state_init(DIFFERENTIAL_TAPE_WIDTH)};
+    EngineResult candidate = {.tape = tape_state_init(DIFFERENTIAL_TAPE_WIDTH)};
+    Machine machine;
+    for (usize index = worker->first_index; index < worker->machine_count && !worker->divergences; index += worker->stride) {
+        differential_machine(index, machine);
+        for (usize i = 0; i < DIFFERENTIAL_ENGINE_COUNT; i++) {
+            if (!engine_diverges(machine, DIFFERENTIAL_MAX_STEPS, &differential_engines[i], &reference, &candidate)) continue;
+            usize steps = shrink_divergence(machine, DIFFERENTIAL_MAX_STEPS, &differential_engines[i], &reference, &candidate);
+            char code[TM_CODE_LENGTH + 1];
+            write_machine_code(machine, code);
+            fprintf(stderr, "Engine %s diverges from the reference on %s after %llu steps (machine %llu)\n",
+                differential_engines[i].name, code, (u64)steps, (u64)index);
+            worker->divergences++;
+        }
+        worker->machines_checked++;
+    }
+    free(reference.tape.tape);
+    free(candidate.tape.tape);
+    return NULL;
+}
+
+void test_differential_simulation() {
+    long core_count = sysconf(_SC_NPROCESSORS_ONLN);
+    usize thread_count = (core_count < 1) ? 1 : (core_count > DIFFERENTIAL_MAX_THREADS) ? DIFFERENTIAL_MAX_THREADS : core_count;
+    usize machine_count = differential_enumerated_count() + DIFFERENTIAL_RANDOM_MACHINES;
+
+    DifferentialWorker workers[DIFFERENTIAL_MAX_THREADS] = {0};
+    for (usize i = 0; i < thread_count; i++) {
+        DifferentialWorker worker = {.first_index = i, .stride = thread_count, .machine_count = machine_count};
+        workers[i] = worker;
+        assert("Failed to start a worker thread", !pthread_create(&workers[i].thread, NULL, differential_worker, &workers[i]));
+    }
+    usize machines_checked = 0;
+    usize divergences = 0;
+    for (usize i = 0; i < thread_count; i++) {
+        pthread_join(workers[i].thread, NULL);
+        machines_checked += workers[i].machines_checked;
+        divergences += workers[i].divergences;
+    }
+    assert("Simulation engines diverge from the reference simulator", divergences == 0);
+    assert("Not every machine was checked", machines_checked == machine_count);
+
+    fprintf(stderr, "Differential simulation tests passed (%llu machines, %llu threads)\n", (u64)machines_checked, (u64)thread_count);
+}
+
 /// Reads in command line arguments. Standard main function stuff.
 int main(int argc, char* argv[]) {
     // These tests are laid out in order of dependency
     // If an earlier one fails, the other ones will (probably) fail
     test_arena_allocator();
     test_parsing();
+    test_tm_list_scanning();
     test_unaccelerated_running();
     test_rle_collapse();
+    test_differential_simulation();
+    test_block_interning();
+    test_closed_tape_language();
+    test_backward_reasoning();
+    test_symbolic_bouncer();
+    test_certificates();
+    test_progress_reporting();
 
     fprintf(stderr, "\nAll tests passing\n");
     return 0;
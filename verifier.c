@@ -0,0 +1,71 @@
+#define PARAMS
+
+#define STATES 7
+#define SYMBOLS 2
+
+// Comment this line out to remove all assertions
+// This makes the code run faster, but removes all safety checks.
+#define DEBUG
+
+#include "inductive_decider.c"
+
+/// Checks one line of a results file. Returns false if the line is malformed or its certificate doesn't hold.
+bool verify_result_line(String line, DecisionStatus* OUT_status) {
+    String code = _next_token(&line);
+    String verdict = _next_token(&line);
+    Machine machine = {0};
+    if (parse_machine_fixed_width(machine, code) != SUCCESS) return false;
+
+    DecisionStatus status;
+    if (_token_equals(verdict, "HALTS")) status = HALTS;
+    else if (_token_equals(verdict, "INFINITE")) status = INFINITE;
+    else if (_token_equals(verdict, "UNDECIDED")) status = UNDECIDED;
+    else return false;
+    *OUT_status = status;
+
+    DecisionCertificate certificate;
+    if (!parse_certificate(line, &certificate)) return false;
+    return verify_certificate(machine, status, &certificate);
+}
+
+/// Checks every certificate in a results file written by the decider.
+/// Exits with a non-zero status if any of them fail.
+int main(int argc, char* argv[]) {
+    assert("Less than 1 argument (indicates an error)", argc > 0);
+    if (argc < 2) {
+        fprintf(stderr, "Usage: ./<exe> <results file>\n");
+        return 0;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    assert("Reading results file failed (does the file exist?)", in);
+    String file_contents = read_file_unbuffered(in);
+    fclose(in);
+
+    usize verified[UNDECIDED + 1] = {0};
+    usize failed = 0;
+    usize line_number = 0;
+    usize position = 0;
+    while (position < file_contents.length) {
+        bool has_illegal_chars;
+        usize line_end = scan_tm_line(file_contents, position, &has_illegal_chars);
+        String line = {.str = &file_contents.str[position], .length = line_end - position};
+        position = line_end + 1;
+        line_number++;
+        String remaining = line;
+        if (!_next_token(&remaining).length) continue;
+
+        DecisionStatus status = UNDECIDED;
+        if (verify_result_line(line, &status)) {
+            verified[status]++;
+        } else {
+            fprintf(stderr, "Line %llu failed verification: %.*s\n", (u64)line_number, (int)line.length, line.str);
+            failed++;
+        }
+    }
+    free(file_contents.str);
+
+    printf("%llu HALTS, %llu INFINITE, %llu UNDECIDED verified. %llu failed.\n",
+        (u64)verified[HALTS], (u64)verified[INFINITE], (u64)verified[UNDECIDED], (u64)failed);
+    return failed ? 1 : 0;
+}